@@ -0,0 +1,152 @@
+#!/bin/sh
+#
+#  bench.sh:  throughput benchmark for mkpasswd
+#
+#	usage: bench.sh [-s] [binary ...]
+#
+#  Runs each binary (one per entropy backend, see the Makefile)
+#  across assembly kernels, separators, the CSPRNG mode and thread
+#  counts, and prints one line of key=value pairs per run, built
+#  from the binary's own --stats counters:
+#
+#	phrases_per_sec, ns_per_phrase	wall-clock rate of generation
+#	mb_per_sec			output rate, in 10^6 bytes
+#	syscalls_per_phrase		RNG plus write(2) calls
+#	entropy_bytes_per_phrase	bytes drawn from the system RNG
+#
+#  Each binary is first run BENCH_STARTUP times (default 200) as a
+#  hook would run it, for one phrase, and a "startup" line gives
+#
+#	us_per_spawn		wall-clock time of a run, fork and
+#				exec included (needs date +%N)
+#	first_byte_cpu_us	CPU time up to the first byte written,
+#				from --stats
+#
+#  With -s only that is done.
+#  BENCH_COUNT (default 2000000) sets the phrases per run and
+#  BENCH_THREADS (default "1 2 4") the thread counts tried.  With
+#  BENCH_DICT set to a dictionary made by mkdict, each index
+#  sampler is also run with it, against the built-in list.  Output
+#  goes to /dev/null but for the runs made to a file (-o, with and
+#  without --fsync) and through a pipe (vmsplice on Linux).
+
+COUNT=${BENCH_COUNT:-2000000}
+THREADS=${BENCH_THREADS:-"1 2 4"}
+STATS=${TMPDIR:-/tmp}/mkpasswd-bench.$$
+OUT=${TMPDIR:-/tmp}/mkpasswd-bench-out.$$
+
+trap 'rm -f "$STATS" "$OUT"' 0 1 2 15
+
+STARTUP=${BENCH_STARTUP:-200}
+only_startup=
+if [ "$1" = -s ]; then
+	only_startup=1
+	shift
+fi
+[ $# -gt 0 ] || set -- ./mkpasswd
+
+run() {
+	bin=$1; shift
+	"$bin" -n "$COUNT" --stats "$@" 2>"$STATS" >/dev/null || failed "$@"
+	report "$@"
+}
+
+# the same, into a pipe
+run_pipe() {
+	bin=$1; shift
+	{ "$bin" -n "$COUNT" --stats "$@" 2>"$STATS" || echo >"$OUT"; } |
+	    dd of=/dev/null bs=1048576 2>/dev/null
+	[ ! -s "$OUT" ] || failed "$@"
+	report "$@" "|"
+}
+
+failed() {
+	echo "bench.sh: $bin $* failed" >&2
+	cat "$STATS" >&2
+	exit 1
+}
+
+# a clock in ns, or nothing where date has no %N
+now() {
+	t=$(date +%s%N)
+	case $t in
+	*N*)	;;
+	*)	echo "$t" ;;
+	esac
+}
+
+startup() {
+	bin=$1
+	t0=$(now)
+	i=0
+	while [ $i -lt "$STARTUP" ]; do
+		"$bin" >/dev/null || failed
+		i=$((i + 1))
+	done
+	t1=$(now)
+	: >"$STATS"
+	i=0
+	while [ $i -lt "$STARTUP" ]; do
+		"$bin" --stats >/dev/null 2>>"$STATS" || failed --stats
+		i=$((i + 1))
+	done
+	awk -F= -v bin="$bin" -v runs="$STARTUP" -v t0="$t0" -v t1="$t1" '
+	    $1 == "backend" { backend = $2 }
+	    $1 == "kernel" { kernel = $2 }
+	    $1 == "first_byte_cpu_ns" { cpu += $2 }
+	    END {
+		printf "startup binary=%s backend=%s kernel=%s runs=%d", \
+		    bin, backend, kernel, runs
+		if (t0 != "" && t1 != "")
+			printf " us_per_spawn=%.1f", (t1 - t0) / runs / 1e3
+		printf " first_byte_cpu_us=%.1f\n", cpu / runs / 1e3
+	    }' "$STATS"
+}
+
+report() {
+	awk -F= -v args="$*" '
+	    { v[$1] = $2 }
+	    END {
+		n = v["phrases"]; ns = v["elapsed_ns"]
+		if (ns == 0) ns = 1
+		printf "backend=%s kernel=%s sampler=%s threads=%s csprng=%s", \
+		    v["backend"], v["kernel"], v["sampler"], v["threads"], \
+		    v["csprng"]
+		printf " output=%s args=\"%s\"", v["output"], args
+		printf " phrases=%d phrases_per_sec=%.0f ns_per_phrase=%.2f", \
+		    n, n * 1e9 / ns, ns / n
+		printf " mb_per_sec=%.1f", v["bytes_written"] * 1e3 / ns
+		printf " syscalls_per_phrase=%.6f entropy_bytes_per_phrase=%.4f", \
+		    (v["rng_syscalls"] + v["write_calls"]) / n, v["rng_bytes"] / n
+		printf " rejects_per_phrase=%.4f\n", v["index_rejects"] / n
+	    }' "$STATS"
+}
+
+for bin in "$@"; do
+	startup "$bin"
+	[ -z "$only_startup" ] || continue
+	kernels=$("$bin" --selftest 2>/dev/null | sed -n 's/^kernel \(.*\): ok$/\1/p')
+	for kernel in $kernels scalar; do
+		for sep in "" -d; do
+			run "$bin" --kernel "$kernel" $sep
+		done
+	done
+	for csprng in "" --csprng; do
+		for j in $THREADS; do
+			run "$bin" -j "$j" $csprng
+		done
+	done
+	for format in nul jsonl "jsonl --indices"; do
+		run "$bin" --csprng -d --format=$format
+	done
+	run "$bin" --csprng -d -o "$OUT"
+	run "$bin" --csprng -d -o "$OUT" --fsync
+	rm -f "$OUT"
+	run_pipe "$bin" --csprng -d
+	run_pipe "$bin" --csprng -d --format=jsonl --indices
+	[ -n "$BENCH_DICT" ] || continue
+	for sampler in auto multiply mask; do
+		run "$bin" --csprng -d --sampler "$sampler"
+		run "$bin" --csprng -d --sampler "$sampler" -f "$BENCH_DICT"
+	done
+done
@@ -0,0 +1,150 @@
+/*
+ *    Copyright (c) 2013 Michael Sierchio
+ *    
+ *    All rights reserved.
+ *    
+ *    Redistribution and use in source and binary forms, with or
+ *    without modification, are permitted provided that the
+ *    following conditions are met:
+ *    
+ *    1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer.
+ *    
+ *    2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *    
+ *    THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS
+ *    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+ *    SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *    OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ *    THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ *    OF SUCH DAMAGE.
+ */
+
+
+/*
+ *  dict.h:  on-disk dictionary format, written by mkdict and
+ *           mapped by libmkpasswd
+ *
+ *          A dictionary file is a header, an array of nwords + 1
+ *          word offsets into the text, an array of nwords word
+ *          lengths, the text itself (the words back to back,
+ *          unterminated, followed by DICT_PAD zero bytes) and,
+ *          for decoding, a minimal perfect hash of the words with
+ *          case folded.  All
+ *          integers are in host byte order (the byteorder field
+ *          catches a file from the other kind of host), and every
+ *          section starts on a DICT_ALIGN boundary, so the file is
+ *          used in place once mapped.
+ */
+
+#ifndef DICT_H
+#define DICT_H
+
+#include <stdint.h>
+
+#define	DICT_MAGIC	"MKPWDICT"
+#define	DICT_VERSION	4
+#define	DICT_BYTEORDER	0x01020304u
+#define	DICT_ALIGN	64
+#define	DICT_WORD_MAX	64		/* longest word, in bytes */
+#define	DICT_PAD	DICT_WORD_MAX
+#define	DICT_MAX_WORDS	(1u << 24)
+
+/*
+ *  Facts established by mkdict, so that nothing is checked at
+ *  run time.  "Decodable" means phrases written without a
+ *  separator can only be split into words one way.
+ */
+#define	DICT_F_UNIQUE		0x01	/* no word appears twice */
+#define	DICT_F_DECODABLE	0x02	/* ... as written */
+#define	DICT_F_DECODABLE_NOCASE	0x04	/* ... even with case ignored */
+#define	DICT_F_MPH		0x08	/* has the hash (words differ
+					   when case is folded) */
+
+struct dict_header {
+    char        magic[8];
+    uint32_t    version;
+    uint32_t    byteorder;
+    uint32_t    nwords;
+    uint32_t    minlen, maxlen;     /* word lengths, in bytes */
+    uint32_t    flags;              /* DICT_F_* */
+    uint32_t    sample_bits;        /* bits drawn per word ... */
+    uint32_t    sample_reject;      /* ... and 2^sample_bits % nwords */
+    double      bits;               /* per word: log2(nwords) */
+    uint64_t    off_off;            /* uint32_t off[nwords + 1] */
+    uint64_t    len_off;            /* uint8_t len[nwords] */
+    uint64_t    text_off;
+    uint64_t    text_len;           /* without the padding */
+    uint64_t    size;               /* of the whole file */
+    uint64_t    mph_seed;
+    uint32_t    mph_buckets;
+    uint32_t    mph_pad;
+    uint64_t    pilot_off;          /* uint32_t pilot[mph_buckets] */
+    uint64_t    slot_off;           /* uint32_t slot[nwords]: word index */
+};
+
+/*
+ *  A word is drawn as in Lemire's multiply-shift method: v is
+ *  sample_bits random bits, m = v * nwords, the index is
+ *  m >> sample_bits, and the draw is rejected if the low
+ *  sample_bits of m are below sample_reject, which leaves every
+ *  index equally likely without a division.  mkdict picks the
+ *  width that draws the fewest bits per word on average; for
+ *  2^k words it is k and nothing is ever rejected.
+ */
+
+/*
+ *  The hash (PTHash-style hash and displace):  a key is hashed
+ *  once, the high half picks one of mph_buckets buckets, and the
+ *  bucket's pilot, chosen by mkdict, sends the bucket's keys to
+ *  distinct free slots of [0, nwords).  A lookup is one hash, two
+ *  table loads and a compare against the word found.  Keys are
+ *  the words with ASCII letters folded to lower case.
+ */
+static inline unsigned
+dict_fold(unsigned char c) {
+    return (unsigned)(c - 'A') < 26u ? c | 0x20 : c;
+}
+
+static inline uint64_t
+dict_hash(const char *s, size_t len, uint64_t seed) {
+    uint64_t    h = seed ^ (len * 0x9e3779b97f4a7c15ULL), v;
+    size_t      i, k;
+
+    for (i = 0; i < len; i += 8) {
+        for (v = 0, k = 0; k < 8 && i + k < len; k++)
+            v |= (uint64_t)dict_fold(s[i+k]) << (8 * k);
+        h = (h ^ v) * 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 31;
+    }
+    h *= 0x94d049bb133111ebULL;
+    return h ^ (h >> 29);
+}
+
+static inline uint32_t
+dict_bucket(uint64_t h, uint32_t nbuckets) {
+    return (uint32_t)(((h >> 32) * nbuckets) >> 32);
+}
+
+static inline uint32_t
+dict_slot(uint64_t h, uint32_t pilot, uint32_t n) {
+    uint64_t    x = h ^ ((pilot + 1ULL) * 0x9e3779b97f4a7c15ULL);
+
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return (uint32_t)(((x >> 32) * n) >> 32);
+}
+
+#endif /* DICT_H */
@@ -0,0 +1,2741 @@
+/*
+ *    Copyright (c) 2013 Michael Sierchio
+ *    
+ *    All rights reserved.
+ *    
+ *    Redistribution and use in source and binary forms, with or
+ *    without modification, are permitted provided that the
+ *    following conditions are met:
+ *    
+ *    1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer.
+ *    
+ *    2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *    
+ *    THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS
+ *    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+ *    SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *    OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ *    THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ *    OF SUCH DAMAGE.
+ */
+
+
+
+/*
+ *  libmkpasswd:  dictionary, entropy sources and phrase assembly
+ *
+ *          See mkpasswd.h for the interface and mkpasswd.c for the
+ *          security argument.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dict.h"
+#include "mkpasswd.h"
+
+
+#define	WORD_MAX		4	/* longest word in the built-in table */
+#define	PHRASE_MAX(nw)		((nw) * (WORD_MAX + 1))
+#define	IDXBUF			1536	/* indices drawn per batch */
+#define	IDX_SLACK		8
+#define	ASSEMBLE_SLACK		32
+#define	CHECK_PHRASES		(IDXBUF / MKPASSWD_MAX_WORDS)
+#define	CTX_SEEDED		0x100	/* ctx->flags: mkpasswd_set_seed() */
+
+/*
+ *  Stage timing for --stats, built with -DMKPASSWD_TIMING.  The
+ *  clock is read per refill and per batch of IDXBUF indices, not
+ *  per phrase, so the cost is a few vDSO calls per thousand words.
+ */
+#ifdef MKPASSWD_TIMING
+static inline unsigned long long
+stage_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#define	STAGE_START(t)		((t) = stage_ns())
+#define	STAGE_ADD(acc, t)	((acc) += stage_ns() - (t))
+#else
+#define	STAGE_START(t)		((void)(t))
+#define	STAGE_ADD(acc, t)	((void)(t))
+#endif
+
+#ifdef __linux__
+#define	RANDDEV	"/dev/urandom"
+#else
+#define	RANDDEV	"/dev/random"
+#endif
+
+/*
+ *  Entropy backend, selectable with -DENTROPY_BACKEND=BACKEND_xxx.
+ *  Linux defaults to getrandom(2), the BSDs and OS X to
+ *  arc4random_buf(3); anything else reads RANDDEV.
+ */
+#define	BACKEND_DEVICE		0
+#define	BACKEND_GETRANDOM	1
+#define	BACKEND_GETENTROPY	2
+#define	BACKEND_ARC4RANDOM	3
+
+#ifndef ENTROPY_BACKEND
+#if defined(__linux__)
+#define	ENTROPY_BACKEND	BACKEND_GETRANDOM
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || \
+    defined(__NetBSD__) || defined(__DragonFly__)
+#define	ENTROPY_BACKEND	BACKEND_ARC4RANDOM
+#else
+#define	ENTROPY_BACKEND	BACKEND_DEVICE
+#endif
+#endif
+
+#if ENTROPY_BACKEND == BACKEND_GETRANDOM
+#include <sys/random.h>
+#elif ENTROPY_BACKEND == BACKEND_GETENTROPY && defined(__APPLE__)
+#include <sys/random.h>
+#endif
+
+
+/*
+ *  The built-in list, generated from words.txt by mkdict -c.
+ *
+ *  The words are stored as fixed 4-byte slots, 3-letter words
+ *  padded with a NUL, so the whole table is 8 KiB and each word
+ *  is moved with a single 32-bit copy.  Slots are not terminated.
+ *  Bit i of wordlen4 is set when words[i] has four letters: 256
+ *  bytes, so it sits in L1 next to the slots.  shuftab[s][c][m]
+ *  assembles a group of c words whose 4-letter members are flagged
+ *  in m (bits above c are ignored); s says whether a separator
+ *  follows each word.  mph_pilot and mph_slot are the minimal
+ *  perfect hash of the words with case folded, for
+ *  mkpasswd_decode().
+ */
+struct shuf {
+    uint8_t     ctrl[16];       /* source byte, 0x80 = zero */
+    uint8_t     term[16];       /* 0xff where a separator goes */
+    uint8_t     len;
+} __attribute__((aligned(16)));
+
+#include "words.h"
+
+#define	NWORDS	(sizeof(words) / sizeof(words[0]))
+
+
+/*
+ *  Entropy backends.  The default is chosen at compile time (see
+ *  ENTROPY_BACKEND above); the syscall backends fall back to
+ *  RANDDEV at run time if the kernel or a sandbox refuses them.
+ */
+struct mkpasswd_backend {
+    const char  *name;
+    int         (*fill)(mkpasswd_ctx *, unsigned char *, size_t);
+};
+
+static int
+device_fill(mkpasswd_ctx *e, unsigned char *p, size_t n) {
+    ssize_t     r;
+
+    if (e->fd < 0) {
+        e->stats.rng_syscalls++;
+        if ((e->fd = open(RANDDEV, O_RDONLY | O_CLOEXEC)) < 0)
+            return -1;
+    }
+    while (n > 0) {
+        e->stats.rng_syscalls++;
+        r = read(e->fd, p, n);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r <= 0) {
+            if (r == 0)
+                errno = EIO;
+            return -1;
+        }
+        p += r;
+        n -= r;
+    }
+    return 0;
+}
+
+static const struct mkpasswd_backend device_backend = { RANDDEV, device_fill };
+
+#if ENTROPY_BACKEND == BACKEND_GETRANDOM
+static int
+getrandom_fill(mkpasswd_ctx *e, unsigned char *p, size_t n) {
+    ssize_t     r;
+
+    while (n > 0) {
+        e->stats.rng_syscalls++;
+        r = getrandom(p, n, 0);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r < 0)
+            return -1;
+        p += r;
+        n -= r;
+    }
+    return 0;
+}
+
+static const struct mkpasswd_backend default_backend = { "getrandom", getrandom_fill };
+#elif ENTROPY_BACKEND == BACKEND_GETENTROPY
+static int
+getentropy_fill(mkpasswd_ctx *e, unsigned char *p, size_t n) {
+    size_t      chunk;
+
+    /* getentropy() caps each request at 256 bytes */
+    for (; n > 0; p += chunk, n -= chunk) {
+        chunk = n < 256 ? n : 256;
+        e->stats.rng_syscalls++;
+        if (getentropy(p, chunk) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+static const struct mkpasswd_backend default_backend = { "getentropy", getentropy_fill };
+#elif ENTROPY_BACKEND == BACKEND_ARC4RANDOM
+static int
+arc4random_fill(mkpasswd_ctx *e, unsigned char *p, size_t n) {
+    (void)e;
+    arc4random_buf(p, n);
+    return 0;
+}
+
+static const struct mkpasswd_backend default_backend = { "arc4random", arc4random_fill };
+#else
+#define	default_backend	device_backend
+#endif
+
+/*
+ *  Fill p from the current backend, dropping back to RANDDEV once
+ *  if the syscall is missing (ENOSYS) or filtered (EPERM).
+ */
+static int
+entropy_fill(mkpasswd_ctx *e, unsigned char *p, size_t n) {
+    e->stats.rng_bytes += n;
+    if (e->backend->fill(e, p, n) == 0)
+        return 0;
+    if (e->backend != &device_backend && (errno == ENOSYS || errno == EPERM)) {
+        e->backend = &device_backend;
+        if (e->backend->fill(e, p, n) == 0)
+            return 0;
+    }
+    return -1;
+}
+
+/*
+ *  Overwrite secrets in a way the compiler may not elide.
+ */
+#if (defined(__GLIBC__) && (__GLIBC__ > 2 || \
+    (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 25))) || \
+    defined(__OpenBSD__) || defined(__FreeBSD__)
+#define	HAVE_EXPLICIT_BZERO
+#else
+static void *(*const volatile wipe_memset)(void *, int, size_t) = memset;
+#endif
+
+static void
+wipe(void *p, size_t n) {
+#ifdef HAVE_EXPLICIT_BZERO
+    explicit_bzero(p, n);
+#else
+    wipe_memset(p, 0, n);
+#endif
+}
+
+void
+mkpasswd_secure_wipe(void *p, size_t n) {
+    wipe(p, n);
+}
+
+/*
+ *  The secure arena: one mapping, locked and kept out of core
+ *  dumps, made once, so that no allocation on the way costs a
+ *  syscall or a page fault.  Blocks are whole pages taken from the
+ *  front; a freed block is wiped and put on a list, its first
+ *  bytes holding the link, for the next request it is big enough
+ *  for, and what that request leaves of it stays on the list.  The
+ *  list is kept in address order and a freed block is joined to
+ *  its free neighbours, or handed back to the front if it ends
+ *  there, so that buffers freed and taken again bigger do not eat
+ *  the arena page by page.  Requests the arena cannot meet are met
+ *  by the heap, with the same alignment, and still wiped when
+ *  freed.
+ */
+struct secure_free {
+    struct secure_free  *next;
+    size_t              size;
+};
+
+static struct {
+    int                 lock;
+    char                *base;
+    size_t              size, used, page;
+    int                 locked;
+    unsigned long long  fallbacks;
+    struct secure_free  *free;
+} arena;
+
+static inline void
+arena_lock(void) {
+    while (__atomic_exchange_n(&arena.lock, 1, __ATOMIC_ACQUIRE))
+        while (__atomic_load_n(&arena.lock, __ATOMIC_RELAXED))
+            sched_yield();
+}
+
+static inline void
+arena_unlock(void) {
+    __atomic_store_n(&arena.lock, 0, __ATOMIC_RELEASE);
+}
+
+int
+mkpasswd_secure_init(size_t size) {
+    void    *p;
+
+    if (arena.base != NULL) {
+        errno = EBUSY;
+        return -1;
+    }
+    if (arena.page == 0)
+        arena.page = sysconf(_SC_PAGESIZE);
+    size = (size + arena.page - 1) / arena.page * arena.page;
+    p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON,
+        -1, 0);
+    if (p == MAP_FAILED)
+        return -1;
+#if defined(MADV_DONTDUMP)
+    madvise(p, size, MADV_DONTDUMP);
+#elif defined(MADV_NOCORE)
+    madvise(p, size, MADV_NOCORE);
+#endif
+    /* faults every page in now rather than on the hot path */
+    arena.locked = mlock(p, size) == 0;
+    arena_lock();
+    arena.base = p;
+    arena.size = size;
+    arena_unlock();
+    return arena.locked ? 0 : 1;
+}
+
+void *
+mkpasswd_secure_alloc(size_t n) {
+    struct secure_free  **fp, *f, *t;
+    void                *p = NULL;
+
+    arena_lock();
+    if (arena.page == 0)
+        arena.page = sysconf(_SC_PAGESIZE);
+    n = (n + arena.page - 1) / arena.page * arena.page;
+    if (arena.base != NULL) {
+        for (fp = &arena.free; (f = *fp) != NULL; fp = &f->next)
+            if (f->size >= n) {
+                *fp = f->next;
+                if (f->size > n) {
+                    /* the tail is as zero as the rest */
+                    t = (struct secure_free *)((char *)f + n);
+                    t->size = f->size - n;
+                    t->next = f->next;
+                    *fp = t;
+                }
+                p = f;
+                break;
+            }
+        if (p == NULL && arena.size - arena.used >= n) {
+            p = arena.base + arena.used;
+            arena.used += n;
+        }
+    }
+    if (p == NULL)
+        arena.fallbacks++;
+    arena_unlock();
+    if (p == NULL) {
+        if (posix_memalign(&p, arena.page, n) != 0)
+            return NULL;
+        memset(p, 0, n);
+        return p;
+    }
+    /* a free block is zero but for its link */
+    memset(p, 0, sizeof(struct secure_free));
+    return p;
+}
+
+void
+mkpasswd_secure_free(void *p, size_t n) {
+    struct secure_free  **fp, **lp = NULL, *f = p, *g, *prev = NULL;
+    int                 in;
+
+    if (p == NULL)
+        return;
+    /* mkpasswd_secure_init() may be setting the arena up meanwhile */
+    arena_lock();
+    in = arena.base != NULL && (char *)p >= arena.base &&
+        (char *)p < arena.base + arena.size;
+    arena_unlock();
+    if (!in) {
+        wipe(p, n);
+        free(p);
+        return;
+    }
+    n = (n + arena.page - 1) / arena.page * arena.page;
+    wipe(p, n);
+    arena_lock();
+    for (fp = &arena.free; (g = *fp) != NULL && (char *)g < (char *)f;
+        fp = &g->next) {
+        lp = fp;
+        prev = g;
+    }
+    f->size = n;
+    f->next = g;
+    if (g != NULL && (char *)f + f->size == (char *)g) {
+        f->size += g->size;
+        f->next = g->next;
+        memset(g, 0, sizeof(*g));
+    }
+    if (prev != NULL && (char *)prev + prev->size == (char *)f) {
+        prev->size += f->size;
+        prev->next = f->next;
+        memset(f, 0, sizeof(*f));
+        f = prev;
+        fp = lp;
+    } else
+        *fp = f;
+    if (f->next == NULL && (char *)f + f->size == arena.base + arena.used) {
+        *fp = NULL;
+        arena.used -= f->size;
+        memset(f, 0, sizeof(*f));
+    }
+    arena_unlock();
+}
+
+void
+mkpasswd_secure_get_stats(struct mkpasswd_secure_stats *st) {
+    arena_lock();
+    st->size = arena.size;
+    st->used = arena.used;
+    st->locked = arena.locked;
+    st->fallbacks = arena.fallbacks;
+    arena_unlock();
+}
+
+/*
+ *  ChaCha20 block function (20 rounds, 64-bit block counter, zero
+ *  nonce), producing one 64-byte block of keystream.
+ */
+#define	ROTL32(v, n)	((v) << (n) | (v) >> (32 - (n)))
+#define	QR(a, b, c, d)	do {					\
+    a += b; d ^= a; d = ROTL32(d, 16);				\
+    c += d; b ^= c; b = ROTL32(b, 12);				\
+    a += b; d ^= a; d = ROTL32(d, 8);				\
+    c += d; b ^= c; b = ROTL32(b, 7);				\
+} while (0)
+
+static void
+chacha20_block(const uint32_t key[8], uint64_t ctr, unsigned char out[64]) {
+    uint32_t    in[16], x[16];
+    int         i;
+
+    in[0] = 0x61707865; in[1] = 0x3320646e;
+    in[2] = 0x79622d32; in[3] = 0x6b206574;
+    for (i = 0; i < 8; i++)
+        in[4 + i] = key[i];
+    in[12] = (uint32_t)ctr;
+    in[13] = (uint32_t)(ctr >> 32);
+    in[14] = in[15] = 0;
+    memcpy(x, in, sizeof(x));
+    for (i = 0; i < 10; i++) {
+        QR(x[0], x[4], x[8],  x[12]);
+        QR(x[1], x[5], x[9],  x[13]);
+        QR(x[2], x[6], x[10], x[14]);
+        QR(x[3], x[7], x[11], x[15]);
+        QR(x[0], x[5], x[10], x[15]);
+        QR(x[1], x[6], x[11], x[12]);
+        QR(x[2], x[7], x[8],  x[13]);
+        QR(x[3], x[4], x[9],  x[14]);
+    }
+    for (i = 0; i < 16; i++) {
+        x[i] += in[i];
+        out[4*i]   = (unsigned char)x[i];
+        out[4*i+1] = (unsigned char)(x[i] >> 8);
+        out[4*i+2] = (unsigned char)(x[i] >> 16);
+        out[4*i+3] = (unsigned char)(x[i] >> 24);
+    }
+    wipe(x, sizeof(x));
+    wipe(in, sizeof(in));
+}
+
+/*
+ *  Key the DRBG with 256 bits from the system backend, passed
+ *  through block stream * 2^32 of their own keystream, so that
+ *  contexts on different streams never share a key even if the
+ *  system hands two of them the same seed.
+ */
+static int
+drbg_seed(mkpasswd_ctx *e) {
+    unsigned char   seed[64];
+    int             i;
+
+    if (entropy_fill(e, seed, 32) != 0)
+        return -1;
+    for (i = 0; i < 8; i++)
+        e->key[i] = (uint32_t)seed[4*i] | (uint32_t)seed[4*i+1] << 8 |
+            (uint32_t)seed[4*i+2] << 16 | (uint32_t)seed[4*i+3] << 24;
+    chacha20_block(e->key, e->stream << 32, seed);
+    for (i = 0; i < 8; i++)
+        e->key[i] = (uint32_t)seed[4*i] | (uint32_t)seed[4*i+1] << 8 |
+            (uint32_t)seed[4*i+2] << 16 | (uint32_t)seed[4*i+3] << 24;
+    wipe(seed, sizeof(seed));
+    e->stats.seeds++;
+    e->since_seed = 0;
+    return 0;
+}
+
+/*
+ *  Fill p with n bytes of ChaCha20 keystream, then erase the key by
+ *  replacing it with the first half of the following block (fast
+ *  key erasure), so the state left behind reveals nothing about
+ *  output already handed out.
+ */
+static int
+drbg_fill(mkpasswd_ctx *e, unsigned char *p, size_t n) {
+    unsigned char   blk[64];
+    uint64_t        ctr = 0;
+    int             i;
+
+    if ((e->stats.seeds == 0 || (e->reseed != 0 &&
+        e->since_seed >= e->reseed)) && drbg_seed(e) != 0)
+        return -1;
+    e->since_seed += n;
+    for (; n >= sizeof(blk); p += sizeof(blk), n -= sizeof(blk))
+        chacha20_block(e->key, ctr++, p);
+    if (n > 0) {
+        chacha20_block(e->key, ctr++, blk);
+        memcpy(p, blk, n);
+    }
+    chacha20_block(e->key, ctr, blk);
+    for (i = 0; i < 8; i++)
+        e->key[i] = (uint32_t)blk[4*i] | (uint32_t)blk[4*i+1] << 8 |
+            (uint32_t)blk[4*i+2] << 16 | (uint32_t)blk[4*i+3] << 24;
+    wipe(blk, sizeof(blk));
+    return 0;
+}
+
+/*
+ *  The fixed keystream of mkpasswd_set_seed(), continued from where
+ *  the last fill left off, whatever its size.
+ */
+static void
+seeded_fill(mkpasswd_ctx *e, unsigned char *p, size_t n) {
+    unsigned char   blk[64];
+    uint64_t        ctr;
+    size_t          at, c;
+
+    while (n > 0) {
+        ctr = e->stream << 32 | e->since_seed >> 6;
+        at = e->since_seed & 63;
+        if (at == 0 && n >= sizeof(blk)) {
+            chacha20_block(e->key, ctr, p);
+            c = sizeof(blk);
+        } else {
+            chacha20_block(e->key, ctr, blk);
+            c = sizeof(blk) - at < n ? sizeof(blk) - at : n;
+            memcpy(p, blk + at, c);
+        }
+        p += c;
+        n -= c;
+        e->since_seed += c;
+    }
+    wipe(blk, sizeof(blk));
+}
+
+/*
+ *  Fill p with n bytes from e's source, whichever it is.
+ */
+static int
+entropy_source(mkpasswd_ctx *e, unsigned char *p, size_t n) {
+    if (e->flags & CTX_SEEDED) {
+        seeded_fill(e, p, n);
+        return 0;
+    }
+    if (e->flags & MKPASSWD_CSPRNG)
+        return drbg_fill(e, p, n);
+    return entropy_fill(e, p, n);
+}
+
+/*
+ *  Prefetch (mkpasswd_set_prefetch()): a ring of depth blocks the
+ *  size of the context's buffer, filled in turn by a thread that
+ *  owns a context of its own, src, whose backend, descriptor and
+ *  DRBG key nothing else touches.  A refill takes the block at
+ *  tail by swapping buffer pointers, so the spent buffer goes back
+ *  into the ring to be overwritten and nothing is copied; own is
+ *  the buffer the caller gave, to be handed back at the end.  The
+ *  mutex guards head, tail and the counters, once per block.
+ */
+struct mkpasswd_prefetch {
+    mkpasswd_ctx        src;
+    unsigned char       *blk[MKPASSWD_PREFETCH_MAX];
+    int                 err[MKPASSWD_PREFETCH_MAX];
+    unsigned            depth, head, tail;
+    int                 running;
+    unsigned char       *own;
+    size_t              size;
+    unsigned long long  stalls;
+    struct mkpasswd_stats   st;     /* src's, as of its last fill */
+    pthread_mutex_t     mu;
+    pthread_cond_t      filled, taken;
+    pthread_t           tid;
+};
+
+static void *
+prefetch_fill(void *arg) {
+    struct mkpasswd_prefetch    *pf = arg;
+    unsigned    i;
+    int         r;
+
+    pthread_mutex_lock(&pf->mu);
+    for (;;) {
+        while (pf->running && pf->head - pf->tail == pf->depth)
+            pthread_cond_wait(&pf->taken, &pf->mu);
+        if (!pf->running)
+            break;
+        i = pf->head % pf->depth;
+        pthread_mutex_unlock(&pf->mu);
+        r = entropy_source(&pf->src, pf->blk[i], pf->size);
+        pthread_mutex_lock(&pf->mu);
+        pf->err[i] = r != 0 ? (errno != 0 ? errno : EIO) : 0;
+        pf->st = pf->src.stats;
+        pf->head++;
+        pthread_cond_signal(&pf->filled);
+    }
+    pthread_mutex_unlock(&pf->mu);
+    return NULL;
+}
+
+/*
+ *  Swap e's spent buffer for the next full block; returns the
+ *  errno its fill failed with, or 0.
+ */
+static int
+prefetch_take(mkpasswd_ctx *e) {
+    struct mkpasswd_prefetch    *pf = e->prefetch;
+    unsigned char   *t;
+    unsigned        i;
+    int             r;
+
+    pthread_mutex_lock(&pf->mu);
+    if (pf->head == pf->tail)
+        pf->stalls++;
+    while (pf->head == pf->tail)
+        pthread_cond_wait(&pf->filled, &pf->mu);
+    i = pf->tail % pf->depth;
+    t = e->buf;
+    e->buf = pf->blk[i];
+    pf->blk[i] = t;
+    r = pf->err[i];
+    pf->tail++;
+    pthread_cond_signal(&pf->taken);
+    pthread_mutex_unlock(&pf->mu);
+    return r;
+}
+
+static void
+prefetch_stop(mkpasswd_ctx *e) {
+    struct mkpasswd_prefetch    *pf = e->prefetch;
+    unsigned        i;
+
+    if (pf == NULL)
+        return;
+    pthread_mutex_lock(&pf->mu);
+    pf->running = 0;
+    pthread_cond_signal(&pf->taken);
+    pthread_mutex_unlock(&pf->mu);
+    pthread_join(pf->tid, NULL);
+    pthread_cond_destroy(&pf->filled);
+    pthread_cond_destroy(&pf->taken);
+    pthread_mutex_destroy(&pf->mu);
+    /* what is left in e->buf is kept; it is in own from here on */
+    for (i = 0; i < pf->depth; i++)
+        if (pf->blk[i] == pf->own) {
+            memcpy(pf->own, e->buf, pf->size);
+            pf->blk[i] = e->buf;
+            e->buf = pf->own;
+        }
+    for (i = 0; i < pf->depth; i++) {
+        wipe(pf->blk[i], pf->size);
+        mkpasswd_secure_free(pf->blk[i], pf->size);
+    }
+    e->stats.rng_syscalls += pf->st.rng_syscalls;
+    e->stats.rng_bytes += pf->st.rng_bytes;
+    e->stats.seeds += pf->st.seeds;
+    e->stats.prefetch_stalls += pf->stalls;
+    mkpasswd_destroy(&pf->src);
+    e->prefetch = NULL;
+    mkpasswd_secure_free(pf, sizeof(*pf));
+}
+
+/*
+ *  A failed refill is recorded in e->error and leaves zeros in the
+ *  buffer, so the hot path needs no checks: callers test e->error
+ *  once per batch and throw the batch away.
+ */
+static void
+entropy_refill(mkpasswd_ctx *e) {
+    unsigned long long  t = 0;
+    int                 r;
+
+    STAGE_START(t);
+    if (e->prefetch != NULL)
+        r = (errno = prefetch_take(e)) != 0;
+    else
+        r = entropy_source(e, e->buf, e->size);
+    if (r != 0) {
+        if (e->error == 0)
+            e->error = errno != 0 ? errno : EIO;
+        memset(e->buf, 0, e->size);
+    }
+    e->pos = 0;
+    e->len = e->size;
+    e->stats.refills++;
+    e->stats.entropy_bytes += e->size;
+    STAGE_ADD(e->stats.entropy_ns, t);
+}
+
+/*
+ *  Forget whatever is buffered, e.g. after a failed refill.
+ */
+static void
+entropy_discard(mkpasswd_ctx *e) {
+    wipe(e->buf, e->size);
+    e->pos = e->len = 0;
+    e->acc = 0;
+    e->nbits = 0;
+}
+
+/*
+ *  Return the next k (<= 32) bits of the stream, least significant
+ *  bit first.  Bytes are shifted into a 64-bit reservoir as needed,
+ *  so no random bits are discarded between draws: six 11-bit
+ *  indices take 66 bits, i.e. a 9-byte draw for one passphrase.
+ *  It is forced inline, since the index loops of generate() are
+ *  nothing without it and it now has callers enough to be left out.
+ */
+static inline __attribute__((__always_inline__)) uint32_t
+entropy_bits(mkpasswd_ctx *e, unsigned k) {
+    uint32_t    v;
+
+    while (e->nbits < k) {
+        if (e->pos == e->len)
+            entropy_refill(e);
+        e->acc |= (uint64_t)e->buf[e->pos++] << e->nbits;
+        e->nbits += 8;
+    }
+    v = (uint32_t)(e->acc & ((1ULL << k) - 1));
+    e->acc >>= k;
+    e->nbits -= k;
+    return v;
+}
+
+/*
+ *  Number of bits needed to index a table of n entries.
+ */
+static unsigned
+index_bits(uint32_t n) {
+    unsigned    k = 0;
+
+    while ((1ULL << k) < n)
+        k++;
+    return k;
+}
+
+/*
+ *  Uniform index in [0, n) from k bits by multiply-shift (see
+ *  dict.h): r = 2^k % n of the products land in the low part of
+ *  their interval and are rejected.  The bits are taken as a
+ *  32-bit fraction, so that the index is the high word of the
+ *  product and the test for rejection is on the low word, against
+ *  t = r << (32 - k).  For the default table t is 0, and the
+ *  multiply amounts to the identity.
+ */
+static inline uint32_t
+entropy_index(mkpasswd_ctx *e, uint32_t n, unsigned k, uint32_t t) {
+    uint64_t    m;
+
+    for (;;) {
+        m = ((uint64_t)entropy_bits(e, k) << (32 - k)) * n;
+        if ((uint32_t)m >= t)
+            return (uint32_t)(m >> 32);
+        e->stats.rejects++;
+    }
+}
+
+/*
+ *  Uniform index in [0, n) from k = index_bits(n) bits: an
+ *  out-of-range draw is rejected rather than reduced modulo n,
+ *  which would favor the low indices.
+ */
+static inline uint32_t
+entropy_index_mask(mkpasswd_ctx *e, uint32_t n, unsigned k) {
+    uint32_t    v;
+
+    while ((v = entropy_bits(e, k)) >= n)
+        e->stats.rejects++;
+    return v;
+}
+
+static inline uint64_t
+load_le64(const unsigned char *p) {
+    uint64_t    v;
+
+    memcpy(&v, p, sizeof(v));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/*
+ *  entropy_index_mask() for a run of count indices.  The reservoir
+ *  is topped up by an unaligned 64-bit load taking as many whole
+ *  bytes as fit, so 11-bit indices come five to a load rather than
+ *  a byte at a time, and the stream is consumed bit for bit as it
+ *  would be one index at a time.  Near the end of the buffer the
+ *  single draw takes over, refill and all.
+ */
+static inline __attribute__((__always_inline__)) void
+entropy_index_run(mkpasswd_ctx *e, uint32_t *idx, size_t count, uint32_t n,
+    unsigned k) {
+    uint64_t    acc = e->acc;
+    unsigned    nbits = e->nbits, take;
+    size_t      pos = e->pos;
+    uint32_t    v;
+
+    while (count > 0) {
+        if (nbits >= k) {
+            v = (uint32_t)(acc & ((1ULL << k) - 1));
+            acc >>= k;
+            nbits -= k;
+        } else if (e->len - pos >= 8) {
+            take = (63 - nbits) >> 3;
+            acc |= (load_le64(e->buf + pos) &
+                ((1ULL << 8 * take) - 1)) << nbits;
+            pos += take;
+            nbits += 8 * take;
+            continue;
+        } else {
+            e->acc = acc;
+            e->nbits = nbits;
+            e->pos = pos;
+            v = entropy_bits(e, k);
+            acc = e->acc;
+            nbits = e->nbits;
+            pos = e->pos;
+        }
+        if (v < n) {
+            *idx++ = v;
+            count--;
+        } else
+            e->stats.rejects++;
+    }
+    e->acc = acc;
+    e->nbits = nbits;
+    e->pos = pos;
+}
+
+#define	SAMPLER_AUTO		0
+#define	SAMPLER_MULTIPLY	1
+#define	SAMPLER_MASK		2
+
+static const char *const samplers[] = { "auto", "multiply", "mask" };
+
+static inline size_t
+wordlen(uint32_t i) {
+    return 3 + ((wordlen4[i >> 3] >> (i & 7)) & 1);
+}
+
+static inline uint32_t
+wordslot(uint32_t i) {
+    uint32_t    v;
+
+    memcpy(&v, words[i], sizeof(v));
+    return v;
+}
+
+/*
+ *  Bits 0-2 are set for those of q[0..2] that have four letters.
+ */
+static inline unsigned
+lenmask3(const uint32_t *q) {
+    return (wordlen(q[0]) - 3) | (wordlen(q[1]) - 3) << 1 |
+        (wordlen(q[2]) - 3) << 2;
+}
+
+
+/*
+ *  Phrase assembly kernels.  A kernel turns nphr phrases of nw word
+ *  indices each into text and returns the number of bytes written.
+ *  The vector kernels work on groups of three words: the slots are
+ *  loaded into one 16-byte register and a byte shuffle chosen by
+ *  the three word lengths squeezes out the pad bytes and opens a
+ *  hole after each word for the separator.  They may store up to
+ *  ASSEMBLE_SLACK bytes past the end of the text, and may read up
+ *  to IDX_SLACK entries past the end of idx.
+ */
+typedef size_t (*assemble_fn)(char *, const uint32_t *, size_t, unsigned,
+    char);
+
+struct mkpasswd_kernel {
+    const char  *name;
+    assemble_fn fn;
+    int         (*supported)(void);
+};
+
+/*
+ *  Each kernel is written once, as an always-inlined body taking
+ *  nw; SPECIALIZE wraps it in the kernel proper, which switches to
+ *  a copy with nw constant for the common word counts so that the
+ *  word loop is unrolled, and to the generic copy otherwise.
+ */
+#define	KERNEL_BODY	static inline __attribute__((__always_inline__))
+
+#define	SPECIALIZE(attr, name)						\
+attr static size_t							\
+name(char *out, const uint32_t *idx, size_t nphr, unsigned nw, char sep) \
+{									\
+    switch (nw) {							\
+    case 4:	return name##_n(out, idx, nphr, 4, sep);		\
+    case 6:	return name##_n(out, idx, nphr, 6, sep);		\
+    case 8:	return name##_n(out, idx, nphr, 8, sep);		\
+    default:	return name##_n(out, idx, nphr, nw, sep);		\
+    }									\
+}
+
+KERNEL_BODY size_t
+assemble_scalar_n(char *out, const uint32_t *idx, size_t nphr, unsigned nw,
+    char sep) {
+    char        *p = out;
+    size_t      i;
+    unsigned    j;
+
+    for (i = 0; i < nphr; i++, idx += nw) {
+        for (j = 0; j < nw; j++) {
+            /* always copy the whole slot; a short word's pad byte
+               is overwritten by whatever follows it */
+            memcpy(p, words[idx[j]], sizeof(words[0]));
+            p += wordlen(idx[j]);
+            if (sep != 0 && j < nw-1)
+                *p++ = sep;
+        }
+        *p++ = '\n';
+    }
+    return p - out;
+}
+
+SPECIALIZE(, assemble_scalar)
+
+/*
+ *  Constant-time kernels, for a server whose neighbours can time
+ *  it.  The kernels above read the table, the length bitmap and
+ *  the shuffle table at addresses that depend on the words drawn,
+ *  which a co-tenant can see through the cache.  These instead
+ *  read every slot of the table for every word and keep the one
+ *  wanted with a mask, so the addresses touched are the same for
+ *  any phrase; the length comes from the slot's pad byte rather
+ *  than the bitmap, and nothing branches on a word.  A word is not
+ *  stored at its offset in the phrase, which the lengths of the
+ *  words before it decide, but merged into the whole phrase under
+ *  a mask, so only the phrase lengths, which the output gives away
+ *  anyway, show in where the bytes are stored.  ct is portable,
+ *  ct-avx2 is faster; neither is a default.
+ */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define	CT_HALF(i)	(32 * (~(i) & 1))
+#else
+#define	CT_HALF(i)	(32 * ((i) & 1))
+#endif
+#define	CT_LIMBS	((PHRASE_MAX(MKPASSWD_MAX_WORDS) + 7) / 8)
+
+/* all ones if a == b, without a compare the compiler could branch on */
+static inline uint64_t
+ct_eq(uint64_t a, uint64_t b) {
+    return 0 - (((a ^ b) - 1) >> 63);
+}
+
+/*
+ *  Fetch the slots of n indices, four at a time, by a scan of the
+ *  table as 1024 pairs of slots.  slot and idx must have room for
+ *  three entries past n.
+ */
+static void
+ct_gather(uint32_t *slot, const uint32_t *idx, size_t n) {
+    const unsigned char *t = (const unsigned char *)words;
+    uint64_t    row, a0, a1, a2, a3;
+    size_t      i, r;
+
+    for (i = 0; i < n; i += 4) {
+        a0 = a1 = a2 = a3 = 0;
+        for (r = 0; r < NWORDS / 2; r++) {
+            memcpy(&row, t + 8 * r, sizeof(row));
+            a0 |= row & ct_eq(r, idx[i] >> 1);
+            a1 |= row & ct_eq(r, idx[i+1] >> 1);
+            a2 |= row & ct_eq(r, idx[i+2] >> 1);
+            a3 |= row & ct_eq(r, idx[i+3] >> 1);
+        }
+        slot[i] = (uint32_t)(a0 >> CT_HALF(idx[i]));
+        slot[i+1] = (uint32_t)(a1 >> CT_HALF(idx[i+1]));
+        slot[i+2] = (uint32_t)(a2 >> CT_HALF(idx[i+2]));
+        slot[i+3] = (uint32_t)(a3 >> CT_HALF(idx[i+3]));
+    }
+}
+
+/*
+ *  Lay out nphr phrases of nw fetched slots.  Each phrase is built
+ *  as a string of bits in 64-bit limbs, first byte lowest: a word,
+ *  with the separator or newline after it, is shifted to where it
+ *  falls and ORed into every limb under a mask that keeps it only
+ *  in the two it spans.  The phrase is then stored from the front,
+ *  a byte at a time, to its length.
+ */
+KERNEL_BODY size_t
+ct_place(char *out, const uint32_t *slot, size_t nphr, unsigned nw,
+    char sep) {
+    uint64_t        acc[CT_LIMBS], v, lo, hi;
+    unsigned char   c[4];
+    size_t          i, k, n, len = 0, nl = (PHRASE_MAX(nw) + 7) / 8;
+    unsigned        j, wl, s, tail, pos;
+
+    for (i = 0; i < nphr; i++, slot += nw) {
+        memset(acc, 0, nl * sizeof(acc[0]));
+        for (j = 0, pos = 0; j < nw; j++) {
+            memcpy(c, &slot[j], sizeof(c));
+            /* a 3-letter word's pad byte is zero */
+            wl = 3 + ((c[3] + 0xff) >> 8);
+            tail = (unsigned char)(j < nw-1 ? sep : '\n');
+            v = c[0] | (uint64_t)c[1] << 8 | (uint64_t)c[2] << 16 |
+                (uint64_t)c[3] << 24 | (uint64_t)tail << 8 * wl;
+            s = pos & 63;
+            lo = v << s;
+            hi = v >> 1 >> (63 - s);
+            for (k = 0; k < nl; k++)
+                acc[k] |= (lo & ct_eq(k, pos >> 6)) |
+                    (hi & ct_eq(k, (pos >> 6) + 1));
+            pos += 8 * (wl + (tail != 0));
+        }
+        n = pos / 8;
+        for (k = 0; k < n; k++)
+            out[len + k] = (char)(acc[k / 8] >> 8 * (k % 8));
+        len += n;
+    }
+    wipe(acc, sizeof(acc));
+    wipe(c, sizeof(c));
+    return len;
+}
+
+/*
+ *  The body of both kernels: fetch with gather, a batch of whole
+ *  phrases at a time, and lay them out.
+ */
+#define	CT_KERNEL(gather)						\
+    uint32_t    slot[IDXBUF + 3];					\
+    size_t      per = IDXBUF / nw, nb, len = 0;				\
+									\
+    for (; nphr > 0; nphr -= nb, idx += nb * nw) {			\
+        nb = nphr < per ? nphr : per;					\
+        gather(slot, idx, nb * nw);					\
+        len += ct_place(out + len, slot, nb, nw, sep);			\
+    }									\
+    wipe(slot, sizeof(slot));						\
+    return len
+
+KERNEL_BODY size_t
+assemble_ct_n(char *out, const uint32_t *idx, size_t nphr, unsigned nw,
+    char sep) {
+    CT_KERNEL(ct_gather);
+}
+
+SPECIALIZE(, assemble_ct)
+
+/*
+ *  A mapped dictionary, as laid out in dict.h.  Its words may be
+ *  of any length up to DICT_WORD_MAX, so it has a kernel of its own
+ *  that copies each word by its offset and length.
+ */
+struct mkpasswd_dict {
+    const struct dict_header    *hdr;
+    size_t                      mapsize;
+    const uint32_t              *off;
+    const uint8_t               *len;
+    const char                  *text;
+    const uint32_t              *pilot, *slot;  /* NULL without a hash */
+    uint32_t                    nwords;
+    unsigned                    maxlen;
+    unsigned                    sample_bits;
+    uint32_t                    sample_reject;
+};
+
+/*
+ *  The file is not scanned when it is opened, so a corrupt entry
+ *  is clamped here rather than let a copy stray off the mapping;
+ *  the padding after the text covers any in-range start, and also
+ *  the over-read of the fixed 16-byte copy.
+ */
+KERNEL_BODY size_t
+assemble_dict_n(char *out, const uint32_t *idx, size_t nphr, unsigned nw,
+    char sep, const struct mkpasswd_dict *d) {
+    const uint64_t  tlen = d->hdr->text_len;
+    char            *p = out;
+    uint32_t        o;
+    size_t          i, l;
+    unsigned        j;
+
+    for (i = 0; i < nphr; i++, idx += nw) {
+        for (j = 0; j < nw; j++) {
+            o = d->off[idx[j]];
+            l = d->len[idx[j]];
+            o = o <= tlen ? o : 0;
+            l = l <= d->maxlen ? l : d->maxlen;
+            /* short words: one fixed-size copy, trimmed by p */
+            if (d->maxlen <= 16)
+                memcpy(p, d->text + o, 16);
+            else
+                memcpy(p, d->text + o, l);
+            p += l;
+            if (sep != 0 && j < nw-1)
+                *p++ = sep;
+        }
+        *p++ = '\n';
+    }
+    return p - out;
+}
+
+static size_t
+assemble_dict(char *out, const uint32_t *idx, size_t nphr, unsigned nw,
+    char sep, const struct mkpasswd_dict *d) {
+    switch (nw) {
+    case 4:	return assemble_dict_n(out, idx, nphr, 4, sep, d);
+    case 6:	return assemble_dict_n(out, idx, nphr, 6, sep, d);
+    case 8:	return assemble_dict_n(out, idx, nphr, 8, sep, d);
+    default:	return assemble_dict_n(out, idx, nphr, nw, sep, d);
+    }
+}
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define	HAVE_X86_KERNELS
+#include <immintrin.h>
+
+static int
+has_ssse3(void) {
+    return __builtin_cpu_supports("ssse3");
+}
+
+static int
+has_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+
+__attribute__((target("ssse3"))) static inline char *
+group_ssse3(char *p, const uint32_t *q, unsigned c, int s, __m128i sepv) {
+    const struct shuf   *t;
+    __m128i             v;
+
+    v = _mm_setr_epi32(wordslot(q[0]), wordslot(q[1]), wordslot(q[2]), 0);
+    t = &shuftab[s][c][lenmask3(q)];
+    v = _mm_shuffle_epi8(v, _mm_load_si128((const __m128i *)t->ctrl));
+    v = _mm_or_si128(v,
+        _mm_and_si128(_mm_load_si128((const __m128i *)t->term), sepv));
+    _mm_storeu_si128((__m128i *)p, v);
+    return p + t->len;
+}
+
+__attribute__((target("ssse3"))) KERNEL_BODY size_t
+assemble_ssse3_n(char *out, const uint32_t *idx, size_t nphr, unsigned nw,
+    char sep) {
+    const __m128i   sepv = _mm_set1_epi8(sep);
+    char            *p = out;
+    size_t          i;
+    unsigned        j;
+
+    for (i = 0; i < nphr; i++, idx += nw) {
+        for (j = 0; j < nw; j += 3)
+            p = group_ssse3(p, idx + j, nw - j < 3 ? nw - j : 3, sep != 0,
+                sepv);
+        if (sep != 0)
+            p[-1] = '\n';
+        else
+            *p++ = '\n';
+    }
+    return p - out;
+}
+
+SPECIALIZE(__attribute__((target("ssse3"))), assemble_ssse3)
+
+/*
+ *  Two groups per iteration: one gather fetches six slots into
+ *  the two 128-bit lanes, and the lane-local byte shuffle does the
+ *  rest.  The pad bytes found by the zero compare give the length
+ *  masks without touching the bitmap.
+ */
+__attribute__((target("avx2"))) KERNEL_BODY size_t
+assemble_avx2_n(char *out, const uint32_t *idx, size_t nphr, unsigned nw,
+    char sep) {
+    const __m256i   perm = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const __m256i   sepv = _mm256_set1_epi8(sep);
+    const struct shuf   *ta, *tb;
+    __m256i         v, ctrl, term;
+    unsigned        j, m, c;
+    char            *p = out;
+    size_t          i;
+    int             s = sep != 0;
+
+    for (i = 0; i < nphr; i++, idx += nw) {
+        for (j = 0; j + 3 < nw; j += 6) {
+            c = nw - j - 3 < 3 ? nw - j - 3 : 3;
+            v = _mm256_permutevar8x32_epi32(
+                _mm256_loadu_si256((const __m256i *)(idx + j)), perm);
+            v = _mm256_i32gather_epi32((const int *)words, v, 4);
+            m = ~(unsigned)_mm256_movemask_epi8(
+                _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+            ta = &shuftab[s][3][(m >> 3 & 1) | (m >> 6 & 2) | (m >> 9 & 4)];
+            tb = &shuftab[s][c][(m >> 19 & 1) | (m >> 22 & 2) |
+                (m >> 25 & 4)];
+            ctrl = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                _mm_load_si128((const __m128i *)ta->ctrl)),
+                _mm_load_si128((const __m128i *)tb->ctrl), 1);
+            term = _mm256_inserti128_si256(_mm256_castsi128_si256(
+                _mm_load_si128((const __m128i *)ta->term)),
+                _mm_load_si128((const __m128i *)tb->term), 1);
+            v = _mm256_or_si256(_mm256_shuffle_epi8(v, ctrl),
+                _mm256_and_si256(term, sepv));
+            _mm_storeu_si128((__m128i *)p, _mm256_castsi256_si128(v));
+            p += ta->len;
+            _mm_storeu_si128((__m128i *)p, _mm256_extracti128_si256(v, 1));
+            p += tb->len;
+        }
+        if (j < nw)
+            p = group_ssse3(p, idx + j, nw - j, s,
+                _mm256_castsi256_si128(sepv));
+        if (s)
+            p[-1] = '\n';
+        else
+            *p++ = '\n';
+    }
+    return p - out;
+}
+
+SPECIALIZE(__attribute__((target("avx2"))), assemble_avx2)
+
+/*
+ *  ct_gather() a row of eight slots at a time: 256 loads a word,
+ *  each shared by four words, and a lane permute to pick the slot
+ *  out of the row that survives the masks.
+ */
+__attribute__((target("avx2"))) static void
+ct_gather_avx2(uint32_t *slot, const uint32_t *idx, size_t n) {
+    const __m256i   *rows = (const __m256i *)words;
+    const __m256i   one = _mm256_set1_epi32(1);
+    __m256i         h0, h1, h2, h3, a0, a1, a2, a3, row, r;
+    size_t          i, k;
+
+    for (i = 0; i < n; i += 4) {
+        h0 = _mm256_set1_epi32(idx[i] >> 3);
+        h1 = _mm256_set1_epi32(idx[i+1] >> 3);
+        h2 = _mm256_set1_epi32(idx[i+2] >> 3);
+        h3 = _mm256_set1_epi32(idx[i+3] >> 3);
+        a0 = a1 = a2 = a3 = r = _mm256_setzero_si256();
+        for (k = 0; k < NWORDS / 8; k++, r = _mm256_add_epi32(r, one)) {
+            row = _mm256_load_si256(rows + k);
+            a0 = _mm256_or_si256(a0,
+                _mm256_and_si256(row, _mm256_cmpeq_epi32(h0, r)));
+            a1 = _mm256_or_si256(a1,
+                _mm256_and_si256(row, _mm256_cmpeq_epi32(h1, r)));
+            a2 = _mm256_or_si256(a2,
+                _mm256_and_si256(row, _mm256_cmpeq_epi32(h2, r)));
+            a3 = _mm256_or_si256(a3,
+                _mm256_and_si256(row, _mm256_cmpeq_epi32(h3, r)));
+        }
+        slot[i] = _mm256_cvtsi256_si32(_mm256_permutevar8x32_epi32(a0,
+            _mm256_set1_epi32(idx[i] & 7)));
+        slot[i+1] = _mm256_cvtsi256_si32(_mm256_permutevar8x32_epi32(a1,
+            _mm256_set1_epi32(idx[i+1] & 7)));
+        slot[i+2] = _mm256_cvtsi256_si32(_mm256_permutevar8x32_epi32(a2,
+            _mm256_set1_epi32(idx[i+2] & 7)));
+        slot[i+3] = _mm256_cvtsi256_si32(_mm256_permutevar8x32_epi32(a3,
+            _mm256_set1_epi32(idx[i+3] & 7)));
+    }
+}
+
+__attribute__((target("avx2"))) KERNEL_BODY size_t
+assemble_ct_avx2_n(char *out, const uint32_t *idx, size_t nphr,
+    unsigned nw, char sep) {
+    CT_KERNEL(ct_gather_avx2);
+}
+
+SPECIALIZE(__attribute__((target("avx2"))), assemble_ct_avx2)
+#endif  /* x86 */
+
+#if defined(__aarch64__)
+#define	HAVE_NEON_KERNEL
+#include <arm_neon.h>
+
+KERNEL_BODY size_t
+assemble_neon_n(char *out, const uint32_t *idx, size_t nphr, unsigned nw,
+    char sep) {
+    const uint8x16_t    sepv = vdupq_n_u8((uint8_t)sep);
+    const struct shuf   *t;
+    uint32x4_t          w;
+    uint8x16_t          v;
+    char                *p = out;
+    size_t              i;
+    unsigned            j, c;
+
+    for (i = 0; i < nphr; i++, idx += nw) {
+        for (j = 0; j < nw; j += 3) {
+            c = nw - j < 3 ? nw - j : 3;
+            w = vdupq_n_u32(0);
+            w = vsetq_lane_u32(wordslot(idx[j]), w, 0);
+            w = vsetq_lane_u32(wordslot(idx[j+1]), w, 1);
+            w = vsetq_lane_u32(wordslot(idx[j+2]), w, 2);
+            t = &shuftab[sep != 0][c][lenmask3(idx + j)];
+            /* out-of-range table indices (0x80) yield zero */
+            v = vqtbl1q_u8(vreinterpretq_u8_u32(w), vld1q_u8(t->ctrl));
+            v = vorrq_u8(v, vandq_u8(vld1q_u8(t->term), sepv));
+            vst1q_u8((uint8_t *)p, v);
+            p += t->len;
+        }
+        if (sep != 0)
+            p[-1] = '\n';
+        else
+            *p++ = '\n';
+    }
+    return p - out;
+}
+
+SPECIALIZE(, assemble_neon)
+#endif  /* aarch64 */
+
+/*
+ *  In order of preference; the first supported entry is the default.
+ *  scalar always is, so the constant-time kernels after it are
+ *  only had by asking.
+ */
+static const struct mkpasswd_kernel  kernels[] = {
+#ifdef HAVE_X86_KERNELS
+    { "avx2",   assemble_avx2,      has_avx2 },
+    { "ssse3",  assemble_ssse3,     has_ssse3 },
+#endif
+#ifdef HAVE_NEON_KERNEL
+    { "neon",   assemble_neon,      NULL },
+#endif
+    { "scalar", assemble_scalar,    NULL },
+#ifdef HAVE_X86_KERNELS
+    { "ct-avx2", assemble_ct_avx2,  has_avx2 },
+#endif
+    { "ct",     assemble_ct,        NULL },
+};
+
+#define	NKERNELS	(sizeof(kernels) / sizeof(kernels[0]))
+
+static int
+kernel_ok(const struct mkpasswd_kernel *k) {
+    return k->supported == NULL || k->supported();
+}
+
+static const struct mkpasswd_kernel *
+kernel_default(void) {
+    size_t      i;
+
+    for (i = 0; !kernel_ok(&kernels[i]); i++)
+        ;
+    return &kernels[i];
+}
+
+
+/*
+ *  Calls on one context are serialized by a test-and-set spinlock;
+ *  uncontended, that is one atomic exchange per call.
+ */
+static inline void
+ctx_lock(mkpasswd_ctx *ctx) {
+    while (__atomic_exchange_n(&ctx->lock, 1, __ATOMIC_ACQUIRE))
+        while (__atomic_load_n(&ctx->lock, __ATOMIC_RELAXED))
+            sched_yield();
+}
+
+static inline void
+ctx_unlock(mkpasswd_ctx *ctx) {
+    __atomic_store_n(&ctx->lock, 0, __ATOMIC_RELEASE);
+}
+
+/*
+ *  Policies.  A length limit is met by drawing the phrase whole:
+ *  count[r][b] is the number of r-word sequences of at most b
+ *  letters, a rank below count[nw][budget] is drawn uniformly, and
+ *  the rank is taken apart into words, shortest lengths first.
+ *  The counts run to 2^384 for 16 words from 2^24, hence the small
+ *  bignums below, least significant limb first; every count is at
+ *  most the top one, so the arithmetic stops at its n limbs.
+ */
+#define	BIG_LIMBS	13
+#define	POLICY_EXTRA	2	/* bytes a policy adds to a phrase */
+
+static const char   policy_symbols[8] = "!#$%&*?@";
+
+struct big {
+    uint32_t    l[BIG_LIMBS];
+};
+
+static int
+big_cmp(const struct big *a, const struct big *b, int n) {
+    int     i;
+
+    for (i = n - 1; i >= 0; i--)
+        if (a->l[i] != b->l[i])
+            return a->l[i] < b->l[i] ? -1 : 1;
+    return 0;
+}
+
+static void
+big_add(struct big *a, const struct big *b, int n) {
+    uint64_t    c = 0;
+    int         i;
+
+    for (i = 0; i < n; i++) {
+        c += (uint64_t)a->l[i] + b->l[i];
+        a->l[i] = (uint32_t)c;
+        c >>= 32;
+    }
+}
+
+/* a -= b, for a >= b */
+static void
+big_sub(struct big *a, const struct big *b, int n) {
+    int64_t     c = 0;
+    int         i;
+
+    for (i = 0; i < n; i++) {
+        c += (int64_t)a->l[i] - b->l[i];
+        a->l[i] = (uint32_t)c;
+        c >>= 32;
+    }
+}
+
+static void
+big_mul(struct big *r, const struct big *a, uint32_t m, int n) {
+    uint64_t    c = 0;
+    int         i;
+
+    for (i = 0; i < n; i++) {
+        c += (uint64_t)a->l[i] * m;
+        r->l[i] = (uint32_t)c;
+        c >>= 32;
+    }
+}
+
+/* a /= m; returns the remainder */
+static uint32_t
+big_div(struct big *a, uint32_t m, int n) {
+    uint64_t    c = 0;
+    int         i;
+
+    for (i = n - 1; i >= 0; i--) {
+        c = c << 32 | a->l[i];
+        a->l[i] = (uint32_t)(c / m);
+        c %= m;
+    }
+    return (uint32_t)c;
+}
+
+static unsigned
+big_bits(const struct big *a) {
+    int         i;
+    unsigned    n;
+
+    for (i = BIG_LIMBS - 1; i > 0 && a->l[i] == 0; i--)
+        ;
+    for (n = 0; n < 32 && a->l[i] >> n != 0; n++)
+        ;
+    return 32 * i + n;
+}
+
+static double
+big_log2(const struct big *a) {
+    double  v = 0;
+    int     i;
+
+    for (i = BIG_LIMBS - 1; i >= 0; i--)
+        v = v * 4294967296.0 + a->l[i];
+    return log2(v);
+}
+
+struct mkpasswd_policy {
+    const struct mkpasswd_dict  *dict;
+    unsigned                    nwords;
+    char                        sep;
+    int                         digit, symbol, cap;
+    double                      bits;
+    /* only if max_len rules out some phrases */
+    struct big                  *count;     /* [r * (budget + 1) + b] */
+    unsigned                    budget;     /* letters */
+    int                         limbs;      /* of the top count */
+    unsigned                    minlen, maxlen;
+    uint32_t                    *bylen;     /* word indices by length */
+    uint32_t                    start[DICT_WORD_MAX + 2];
+};
+
+static inline size_t
+policy_wordlen(const struct mkpasswd_policy *p, uint32_t i) {
+    const struct mkpasswd_dict  *d = p->dict;
+
+    if (d == NULL)
+        return wordlen(i);
+    return d->len[i] <= d->maxlen ? d->len[i] : d->maxlen;
+}
+
+static inline const struct big *
+policy_count(const struct mkpasswd_policy *p, unsigned r, unsigned b) {
+    return &p->count[r * (p->budget + 1) + b];
+}
+
+/*
+ *  The nw indices of one phrase that fits the budget.  A draw of
+ *  as many bits as the top count has is rejected if it is not
+ *  below it, which happens less than half the time.  Then, word
+ *  by word, the rank falls in the block of one length l, of
+ *  c_l * count[r - 1][b - l] ranks, and within the block picks
+ *  one of the c_l words and the rank of the rest.
+ */
+static __attribute__((__noinline__)) void
+policy_draw(mkpasswd_ctx *e, const struct mkpasswd_policy *p,
+    uint32_t *idx) {
+    const struct big    *top = policy_count(p, p->nwords, p->budget);
+    struct big          rank, block;
+    unsigned            k = big_bits(top), b = p->budget, r, l, i;
+    uint32_t            c = 0;
+    int                 n;
+
+    for (;;) {
+        for (i = 0; 32 * i < k; i++)
+            rank.l[i] = entropy_bits(e, k - 32 * i < 32 ? k - 32 * i : 32);
+        if (big_cmp(&rank, top, p->limbs) < 0)
+            break;
+        e->stats.rejects++;
+    }
+    for (r = p->nwords; r > 0; r--) {
+        /* the rank is below count[r][b], and shrinks with it */
+        for (n = p->limbs; n > 1 && policy_count(p, r, b)->l[n - 1] == 0;
+            n--)
+            ;
+        for (l = p->minlen; l <= p->maxlen && l <= b; l++) {
+            if ((c = p->start[l + 1] - p->start[l]) == 0)
+                continue;
+            big_mul(&block, policy_count(p, r - 1, b - l), c, n);
+            if (big_cmp(&rank, &block, n) < 0)
+                break;
+            big_sub(&rank, &block, n);
+        }
+        *idx++ = p->bylen[p->start[l] + big_div(&rank, c, n)];
+        b -= l;
+    }
+    wipe(&rank, sizeof(rank));
+}
+
+/*
+ *  Where the digit and the symbol go, and which they are: one draw
+ *  each, of word * 10 + digit and word * 8 + symbol.
+ */
+static __attribute__((__noinline__)) void
+policy_inserts(mkpasswd_ctx *e, const struct mkpasswd_policy *p,
+    uint16_t *ins, size_t nphr) {
+    uint32_t    nd = 10 * p->nwords, ns = 8 * p->nwords;
+    unsigned    kd = index_bits(nd), ks = index_bits(ns);
+    size_t      i;
+
+    for (i = 0; i < nphr; i++, ins += 2) {
+        ins[0] = p->digit ? entropy_index_mask(e, nd, kd) : 0;
+        ins[1] = p->symbol ? entropy_index_mask(e, ns, ks) : 0;
+    }
+}
+
+static inline char
+policy_case(char c, int upper) {
+    if ((unsigned)(c - (upper ? 'a' : 'A')) < 26u)
+        c ^= 0x20;
+    return c;
+}
+
+/*
+ *  Policy phrases have a kernel of their own, which copies each
+ *  word as the others do, then sets its case and makes the inserts.
+ */
+static size_t
+policy_assemble(const struct mkpasswd_policy *p, char *out,
+    const uint32_t *idx, size_t nphr, const uint16_t *ins) {
+    const struct mkpasswd_dict  *d = p->dict;
+    char        *q = out;
+    uint32_t    v, o;
+    size_t      i, l;
+    unsigned    j, nw = p->nwords;
+
+    for (i = 0; i < nphr; i++, idx += nw, ins += 2) {
+        for (j = 0; j < nw; j++) {
+            l = policy_wordlen(p, idx[j]);
+            if (d == NULL) {
+                v = wordslot(idx[j]);
+                memcpy(q, &v, sizeof(v));
+            } else {
+                o = d->off[idx[j]];
+                o = o <= d->hdr->text_len ? o : 0;
+                memcpy(q, d->text + o, d->maxlen <= 16 ? 16 : l);
+            }
+            if (p->cap != MKPASSWD_CAP_ASIS && l > 0)
+                q[0] = policy_case(q[0], p->cap == MKPASSWD_CAP_ALL ||
+                    (p->cap == MKPASSWD_CAP_FIRST && j == 0));
+            q += l;
+            if (p->digit && ins[0] / 10 == j)
+                *q++ = '0' + ins[0] % 10;
+            if (p->symbol && ins[1] / 8 == j)
+                *q++ = policy_symbols[ins[1] % 8];
+            if (p->sep != 0 && j < nw - 1)
+                *q++ = p->sep;
+        }
+        *q++ = '\n';
+    }
+    return q - out;
+}
+
+/*
+ *  Make count phrases of nw words at out, IDXBUF / nw phrases at a
+ *  time: indices for a whole batch are drawn first, then handed to
+ *  the kernel, and copied to save if it is not NULL.  Called with
+ *  the context locked.
+ */
+static ssize_t
+generate(mkpasswd_ctx *ctx, char *out, size_t count, unsigned nw, char sep,
+    uint32_t *save, const struct mkpasswd_policy *pol) {
+    const struct mkpasswd_dict  *d = ctx->dict;
+    uint32_t        idx[IDXBUF + IDX_SLACK];
+    uint16_t        ins[2 * IDXBUF];
+    uint32_t        n = d != NULL ? d->nwords : NWORDS;
+    unsigned        k = index_bits(n);
+    size_t          per = IDXBUF / nw, nb, i, len = 0;
+    unsigned long long  t = 0, refill = 0;
+    int             mask;
+
+    /*
+     *  Drawing the same width, the mask test rejects exactly as
+     *  often and is cheaper than a multiply, so multiply-shift is
+     *  only worth it where a dictionary is drawn wider.
+     */
+    mask = ctx->sampler == SAMPLER_MASK || (ctx->sampler == SAMPLER_AUTO &&
+        (d == NULL || d->sample_bits == k));
+    while (count > 0) {
+        nb = count < per ? count : per;
+        STAGE_START(t);
+        refill = ctx->stats.entropy_ns;
+        /* constants for the default table let the test fold away */
+        if (pol != NULL && pol->count != NULL)
+            for (i = 0; i < nb * nw; i += nw)
+                policy_draw(ctx, pol, idx + i);
+        else if (mask && d == NULL) {
+            i = nb * nw;
+            entropy_index_run(ctx, idx, i, NWORDS, NWORDS_BITS);
+        } else if (mask) {
+            i = nb * nw;
+            entropy_index_run(ctx, idx, i, n, k);
+        } else if (d == NULL)
+            for (i = 0; i < nb * nw; i++)
+                idx[i] = entropy_index(ctx, NWORDS, NWORDS_BITS, 0);
+        else
+            for (i = 0; i < nb * nw; i++)
+                idx[i] = entropy_index(ctx, n, d->sample_bits,
+                    d->sample_reject << (32 - d->sample_bits));
+        /* the vector kernels may look past the end */
+        memset(idx + i, 0, IDX_SLACK * sizeof(idx[0]));
+        if (pol != NULL)
+            policy_inserts(ctx, pol, ins, nb);
+        /* the refills inside count as entropy */
+        STAGE_ADD(ctx->stats.index_ns, t);
+        ctx->stats.index_ns -= ctx->stats.entropy_ns - refill;
+        STAGE_START(t);
+        if (ctx->error != 0) {
+            errno = ctx->error;
+            ctx->error = 0;
+            entropy_discard(ctx);
+            wipe(idx, sizeof(idx));
+            wipe(ins, sizeof(ins));
+            return -1;
+        }
+        if (pol != NULL)
+            len += policy_assemble(pol, out + len, idx, nb, ins);
+        else if (d != NULL)
+            len += assemble_dict(out + len, idx, nb, nw, sep, d);
+        else
+            len += ctx->kernel->fn(out + len, idx, nb, nw, sep);
+        STAGE_ADD(ctx->stats.assemble_ns, t);
+        if (save != NULL) {
+            memcpy(save, idx, nb * nw * sizeof(idx[0]));
+            save += nb * nw;
+        }
+        count -= nb;
+    }
+    wipe(idx, sizeof(idx));
+    if (pol != NULL)
+        wipe(ins, sizeof(ins));
+    return len;
+}
+
+
+int
+mkpasswd_init(mkpasswd_ctx *ctx, int flags, void *buf, size_t bufsize) {
+    if (flags & ~MKPASSWD_CSPRNG) {
+        errno = EINVAL;
+        return -1;
+    }
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->flags = flags;
+    ctx->fd = -1;
+    ctx->backend = &default_backend;
+    ctx->kernel = kernel_default();
+    if (buf == NULL) {
+        ctx->buf = ctx->ibuf;
+        ctx->size = bufsize != 0 && bufsize < sizeof(ctx->ibuf) ?
+            bufsize : sizeof(ctx->ibuf);
+    } else if (bufsize == 0) {
+        errno = EINVAL;
+        return -1;
+    } else {
+        ctx->buf = buf;
+        ctx->size = bufsize;
+    }
+    return 0;
+}
+
+void
+mkpasswd_destroy(mkpasswd_ctx *ctx) {
+    prefetch_stop(ctx);
+    if (ctx->fd >= 0)
+        close(ctx->fd);
+    ctx->fd = -1;
+    wipe(ctx->buf, ctx->size);
+    wipe(ctx->key, sizeof(ctx->key));
+    ctx->acc = 0;
+    ctx->nbits = 0;
+    ctx->pos = ctx->len = 0;
+}
+
+void
+mkpasswd_set_reseed(mkpasswd_ctx *ctx, unsigned long long bytes) {
+    ctx_lock(ctx);
+    ctx->reseed = bytes;
+    ctx_unlock(ctx);
+}
+
+void
+mkpasswd_set_seed(mkpasswd_ctx *ctx, const unsigned char key[32],
+    unsigned long long stream) {
+    int     i;
+
+    ctx_lock(ctx);
+    prefetch_stop(ctx);
+    entropy_discard(ctx);
+    for (i = 0; i < 8; i++)
+        ctx->key[i] = (uint32_t)key[4*i] | (uint32_t)key[4*i+1] << 8 |
+            (uint32_t)key[4*i+2] << 16 | (uint32_t)key[4*i+3] << 24;
+    ctx->flags |= CTX_SEEDED;
+    ctx->stream = stream;
+    ctx->since_seed = 0;
+    ctx_unlock(ctx);
+}
+
+void
+mkpasswd_set_stream(mkpasswd_ctx *ctx, unsigned long long stream) {
+    ctx_lock(ctx);
+    ctx->stream = stream;
+    ctx_unlock(ctx);
+}
+
+int
+mkpasswd_set_prefetch(mkpasswd_ctx *ctx, unsigned depth) {
+    struct mkpasswd_prefetch    *pf;
+    unsigned    i;
+    int         r;
+
+    if (depth > MKPASSWD_PREFETCH_MAX ||
+        (depth != 0 && (ctx->flags & CTX_SEEDED))) {
+        errno = EINVAL;
+        return -1;
+    }
+    ctx_lock(ctx);
+    prefetch_stop(ctx);
+    ctx_unlock(ctx);
+    if (depth == 0)
+        return 0;
+    if ((pf = mkpasswd_secure_alloc(sizeof(*pf))) == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    memset(pf, 0, sizeof(*pf));
+    pf->depth = depth;
+    pf->size = ctx->size;
+    pf->own = ctx->buf;
+    for (i = 0; i < depth; i++)
+        if ((pf->blk[i] = mkpasswd_secure_alloc(pf->size)) == NULL) {
+            while (i-- > 0)
+                mkpasswd_secure_free(pf->blk[i], pf->size);
+            mkpasswd_secure_free(pf, sizeof(*pf));
+            errno = ENOMEM;
+            return -1;
+        }
+    /* the filler's context: the same source, settings and stream */
+    mkpasswd_init(&pf->src, ctx->flags & MKPASSWD_CSPRNG, NULL, 0);
+    ctx_lock(ctx);
+    pf->src.backend = ctx->backend;
+    pf->src.reseed = ctx->reseed;
+    pf->src.stream = ctx->stream;
+    ctx_unlock(ctx);
+    pf->running = 1;
+    pthread_mutex_init(&pf->mu, NULL);
+    pthread_cond_init(&pf->filled, NULL);
+    pthread_cond_init(&pf->taken, NULL);
+    if ((r = pthread_create(&pf->tid, NULL, prefetch_fill, pf)) != 0) {
+        pthread_cond_destroy(&pf->taken);
+        pthread_cond_destroy(&pf->filled);
+        pthread_mutex_destroy(&pf->mu);
+        for (i = 0; i < depth; i++)
+            mkpasswd_secure_free(pf->blk[i], pf->size);
+        mkpasswd_secure_free(pf, sizeof(*pf));
+        errno = r;
+        return -1;
+    }
+    ctx_lock(ctx);
+    ctx->prefetch = pf;
+    ctx_unlock(ctx);
+    return 0;
+}
+
+size_t
+mkpasswd_batch_size(size_t count, unsigned nwords) {
+    return mkpasswd_dict_batch_size(NULL, count, nwords);
+}
+
+double
+mkpasswd_entropy_bits(unsigned nwords) {
+    return mkpasswd_dict_entropy_bits(NULL, nwords);
+}
+
+ssize_t
+mkpasswd_generate(mkpasswd_ctx *ctx, char *out, size_t outlen,
+    unsigned nwords, char sep) {
+    char        tmp[MKPASSWD_MAX_WORDS * (DICT_WORD_MAX + 1) + ASSEMBLE_SLACK];
+    ssize_t     len;
+
+    if (nwords < 1 || nwords > MKPASSWD_MAX_WORDS) {
+        errno = EINVAL;
+        return -1;
+    }
+    ctx_lock(ctx);
+    len = generate(ctx, tmp, 1, nwords, sep, NULL, NULL);
+    ctx_unlock(ctx);
+    if (len < 0)
+        return -1;
+    /* drop the newline */
+    if ((size_t)len > outlen) {
+        wipe(tmp, sizeof(tmp));
+        errno = ERANGE;
+        return -1;
+    }
+    memcpy(out, tmp, --len);
+    out[len] = '\0';
+    wipe(tmp, sizeof(tmp));
+    return len;
+}
+
+ssize_t
+mkpasswd_generate_batch(mkpasswd_ctx *ctx, char *out, size_t outlen,
+    size_t count, unsigned nwords, char sep) {
+    return mkpasswd_generate_batch_idx(ctx, out, outlen, count, nwords, sep,
+        NULL);
+}
+
+ssize_t
+mkpasswd_generate_batch_idx(mkpasswd_ctx *ctx, char *out, size_t outlen,
+    size_t count, unsigned nwords, char sep, uint32_t *idx) {
+    ssize_t     len;
+
+    if (nwords < 1 || nwords > MKPASSWD_MAX_WORDS) {
+        errno = EINVAL;
+        return -1;
+    }
+    ctx_lock(ctx);
+    if (outlen < mkpasswd_dict_batch_size(ctx->dict, count, nwords)) {
+        ctx_unlock(ctx);
+        errno = ERANGE;
+        return -1;
+    }
+    len = generate(ctx, out, count, nwords, sep, idx, NULL);
+    ctx_unlock(ctx);
+    return len;
+}
+
+/*
+ *  Sort the words by length and count the phrases that fit in
+ *  budget letters, unless they all do.  ERANGE if none does.
+ */
+static int
+policy_table(struct mkpasswd_policy *p, unsigned budget) {
+    const struct mkpasswd_dict  *d = p->dict;
+    struct big  block;
+    uint32_t    at[DICT_WORD_MAX + 1], n = d != NULL ? d->nwords : NWORDS;
+    uint32_t    i, c;
+    unsigned    nw = p->nwords, r, b, l;
+
+    for (i = 0; i < n; i++)
+        p->start[policy_wordlen(p, i) + 1]++;
+    for (l = 0; l <= DICT_WORD_MAX; l++)
+        p->start[l + 1] += p->start[l];
+    for (l = 0; p->start[l + 1] == 0; l++)
+        ;
+    p->minlen = l;
+    for (l = DICT_WORD_MAX; p->start[l + 1] == p->start[l]; l--)
+        ;
+    p->maxlen = l;
+    if (budget < nw * p->minlen) {
+        errno = ERANGE;
+        return -1;
+    }
+    if (budget >= nw * p->maxlen)
+        return 0;
+    p->budget = budget;
+    p->bylen = malloc(n * sizeof(*p->bylen));
+    p->count = calloc((nw + 1) * (budget + 1), sizeof(*p->count));
+    if (p->bylen == NULL || p->count == NULL)
+        return -1;
+    memcpy(at, p->start, sizeof(at));
+    for (i = 0; i < n; i++)
+        p->bylen[at[policy_wordlen(p, i)]++] = i;
+    for (b = 0; b <= budget; b++)
+        p->count[b].l[0] = 1;
+    for (r = 1; r <= nw; r++)
+        for (b = 0; b <= budget; b++)
+            for (l = p->minlen; l <= p->maxlen && l <= b; l++)
+                if ((c = p->start[l + 1] - p->start[l]) != 0) {
+                    big_mul(&block, policy_count(p, r - 1, b - l), c,
+                        BIG_LIMBS);
+                    big_add(&p->count[r * (budget + 1) + b], &block,
+                        BIG_LIMBS);
+                }
+    p->limbs = (big_bits(policy_count(p, nw, budget)) + 31) / 32;
+    p->bits = big_log2(policy_count(p, nw, budget));
+    return 0;
+}
+
+mkpasswd_policy *
+mkpasswd_policy_create(const mkpasswd_dict *d,
+    const struct mkpasswd_policy_conf *conf) {
+    struct mkpasswd_policy  *p;
+    unsigned            nw = conf->nwords, fixed;
+
+    if (nw < 1 || nw > MKPASSWD_MAX_WORDS ||
+        conf->capitalize < MKPASSWD_CAP_ASIS ||
+        conf->capitalize > MKPASSWD_CAP_NONE) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /*
+     *  A list may hold words that differ only in case, and setting
+     *  the case would make them one word drawn twice as often; only
+     *  a list with the hash is known to have none.
+     */
+    if (conf->capitalize != MKPASSWD_CAP_ASIS && d != NULL &&
+        d->pilot == NULL) {
+        errno = EDOM;
+        return NULL;
+    }
+    if ((p = calloc(1, sizeof(*p))) == NULL)
+        return NULL;
+    p->dict = d;
+    p->nwords = nw;
+    p->sep = conf->sep;
+    p->digit = conf->digit != 0;
+    p->symbol = conf->symbol != 0;
+    p->cap = conf->capitalize;
+    p->bits = mkpasswd_dict_entropy_bits(d, nw);
+    fixed = (p->sep != 0 ? nw - 1 : 0) + p->digit + p->symbol;
+    if (conf->max_len != 0 && conf->max_len < fixed + nw) {
+        mkpasswd_policy_destroy(p);
+        errno = ERANGE;
+        return NULL;
+    }
+    if (conf->max_len != 0 && policy_table(p, conf->max_len - fixed) != 0) {
+        mkpasswd_policy_destroy(p);
+        return NULL;
+    }
+    if (p->digit)
+        p->bits += log2(10.0 * nw);
+    if (p->symbol)
+        p->bits += log2(8.0 * nw);
+    return p;
+}
+
+void
+mkpasswd_policy_destroy(mkpasswd_policy *p) {
+    if (p == NULL)
+        return;
+    free(p->count);
+    free(p->bylen);
+    free(p);
+}
+
+double
+mkpasswd_policy_entropy_bits(const mkpasswd_policy *p) {
+    return p->bits;
+}
+
+size_t
+mkpasswd_policy_batch_size(const mkpasswd_policy *p, size_t count) {
+    return mkpasswd_dict_batch_size(p->dict, count, p->nwords) +
+        count * POLICY_EXTRA;
+}
+
+ssize_t
+mkpasswd_generate_policy(mkpasswd_ctx *ctx, const mkpasswd_policy *pol,
+    char *out, size_t outlen, size_t count, uint32_t *idx) {
+    ssize_t     len;
+
+    ctx_lock(ctx);
+    if (ctx->dict != pol->dict) {
+        ctx_unlock(ctx);
+        errno = EINVAL;
+        return -1;
+    }
+    if (outlen < mkpasswd_policy_batch_size(pol, count)) {
+        ctx_unlock(ctx);
+        errno = ERANGE;
+        return -1;
+    }
+    len = generate(ctx, out, count, pol->nwords, pol->sep, idx, pol);
+    ctx_unlock(ctx);
+    return len;
+}
+
+/*
+ *  The backend may change underfoot if its syscall turns out to be
+ *  unavailable; a one-byte draw before first use settles it.
+ */
+const char *
+mkpasswd_backend_name(mkpasswd_ctx *ctx) {
+    unsigned char   probe;
+    const char      *name;
+
+    ctx_lock(ctx);
+    if (ctx->flags & CTX_SEEDED)
+        name = "seed";
+    else {
+        if (ctx->stats.rng_bytes == 0)
+            (void)entropy_fill(ctx, &probe, sizeof(probe));
+        name = ctx->backend->name;
+    }
+    ctx_unlock(ctx);
+    return name;
+}
+
+const char *
+mkpasswd_kernel_name(size_t i) {
+    return i < NKERNELS ? kernels[i].name : NULL;
+}
+
+const char *
+mkpasswd_current_kernel(const mkpasswd_ctx *ctx) {
+    return ctx->dict != NULL ? "dict" : ctx->kernel->name;
+}
+
+static const struct mkpasswd_kernel *
+kernel_find(const char *name) {
+    size_t      i;
+
+    for (i = 0; i < NKERNELS; i++)
+        if (strcmp(name, kernels[i].name) == 0) {
+            if (kernel_ok(&kernels[i]))
+                return &kernels[i];
+            errno = ENOTSUP;
+            return NULL;
+        }
+    errno = ENOENT;
+    return NULL;
+}
+
+int
+mkpasswd_set_kernel(mkpasswd_ctx *ctx, const char *name) {
+    const struct mkpasswd_kernel    *k;
+
+    if ((k = kernel_find(name)) == NULL)
+        return -1;
+    ctx_lock(ctx);
+    ctx->kernel = k;
+    ctx_unlock(ctx);
+    return 0;
+}
+
+const char *
+mkpasswd_current_sampler(const mkpasswd_ctx *ctx) {
+    return samplers[ctx->sampler];
+}
+
+int
+mkpasswd_set_sampler(mkpasswd_ctx *ctx, const char *name) {
+    unsigned    i;
+
+    for (i = 0; i < sizeof(samplers) / sizeof(samplers[0]); i++)
+        if (strcmp(name, samplers[i]) == 0) {
+            ctx_lock(ctx);
+            ctx->sampler = i;
+            ctx_unlock(ctx);
+            return 0;
+        }
+    errno = ENOENT;
+    return -1;
+}
+
+int
+mkpasswd_check_kernel(mkpasswd_ctx *ctx, const char *name) {
+    static const char   seps[] = { 0, '-', ' ' };
+    uint32_t    idx[IDXBUF + IDX_SLACK];
+    char        ref[CHECK_PHRASES * PHRASE_MAX(MKPASSWD_MAX_WORDS) +
+                    ASSEMBLE_SLACK];
+    char        got[sizeof(ref)];
+    const struct mkpasswd_kernel    *k;
+    size_t      i, s, rlen, glen;
+    unsigned    nw;
+    int         bad = 0;
+
+    if ((k = kernel_find(name)) == NULL)
+        return -1;
+    ctx_lock(ctx);
+    for (i = 0; i < CHECK_PHRASES * MKPASSWD_MAX_WORDS; i++)
+        idx[i] = entropy_index(ctx, NWORDS, NWORDS_BITS, 0);
+    memset(idx + i, 0, IDX_SLACK * sizeof(idx[0]));
+    if (ctx->error != 0) {
+        errno = ctx->error;
+        ctx->error = 0;
+        entropy_discard(ctx);
+        ctx_unlock(ctx);
+        return -1;
+    }
+    ctx_unlock(ctx);
+    /* make sure the last table entry goes through the gather */
+    idx[0] = NWORDS - 1;
+    for (nw = 1; nw <= MKPASSWD_MAX_WORDS; nw++)
+        for (s = 0; s < sizeof(seps); s++) {
+            rlen = assemble_scalar(ref, idx, CHECK_PHRASES, nw, seps[s]);
+            glen = k->fn(got, idx, CHECK_PHRASES, nw, seps[s]);
+            if (rlen != glen || memcmp(ref, got, rlen) != 0)
+                bad = 1;
+        }
+    wipe(idx, sizeof(idx));
+    return bad;
+}
+
+void
+mkpasswd_get_stats(const mkpasswd_ctx *ctx, struct mkpasswd_stats *st) {
+    struct mkpasswd_prefetch    *pf = ctx->prefetch;
+
+    *st = ctx->stats;
+    /* the RNG is read by the prefetch thread */
+    if (pf != NULL) {
+        pthread_mutex_lock(&pf->mu);
+        st->rng_syscalls += pf->st.rng_syscalls;
+        st->rng_bytes += pf->st.rng_bytes;
+        st->seeds += pf->st.seeds;
+        st->prefetch_stalls += pf->stalls;
+        pthread_mutex_unlock(&pf->mu);
+    }
+}
+
+
+
+/*
+ *  Dictionaries are mapped read-only and shared, so opening one
+ *  costs the same whatever its size: only the header is checked,
+ *  against the size of the file.  mkdict has already vouched for
+ *  the words themselves.
+ */
+mkpasswd_dict *
+mkpasswd_dict_open(const char *path) {
+    const struct dict_header    *h;
+    struct mkpasswd_dict        *d;
+    struct stat     sb;
+    void            *map;
+    int             fd, err;
+
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0)
+        return NULL;
+    if (fstat(fd, &sb) != 0) {
+        err = errno;
+        close(fd);
+        errno = err;
+        return NULL;
+    }
+    if (!S_ISREG(sb.st_mode) || sb.st_size < (off_t)sizeof(*h)) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+    map = mmap(NULL, sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    err = errno;
+    close(fd);
+    if (map == MAP_FAILED) {
+        errno = err;
+        return NULL;
+    }
+    h = map;
+    if (memcmp(h->magic, DICT_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != DICT_VERSION || h->byteorder != DICT_BYTEORDER ||
+        h->size != (uint64_t)sb.st_size ||
+        !(h->flags & DICT_F_UNIQUE) ||
+        h->nwords < 2 || h->nwords > DICT_MAX_WORDS ||
+        h->sample_bits < index_bits(h->nwords) || h->sample_bits > 32 ||
+        h->sample_reject != (1ULL << h->sample_bits) % h->nwords ||
+        h->minlen < 1 || h->minlen > h->maxlen ||
+        h->maxlen > DICT_WORD_MAX ||
+        h->off_off % DICT_ALIGN != 0 ||
+        h->off_off > h->size ||
+        (h->size - h->off_off) / sizeof(uint32_t) < h->nwords + 1ULL ||
+        h->len_off > h->size || h->size - h->len_off < h->nwords ||
+        h->text_off > h->size ||
+        h->size - h->text_off < h->text_len + DICT_PAD ||
+        ((h->flags & DICT_F_MPH) &&
+        (h->mph_buckets == 0 ||
+        h->pilot_off % DICT_ALIGN != 0 || h->slot_off % DICT_ALIGN != 0 ||
+        h->pilot_off > h->size ||
+        (h->size - h->pilot_off) / sizeof(uint32_t) < h->mph_buckets ||
+        h->slot_off > h->size ||
+        (h->size - h->slot_off) / sizeof(uint32_t) < h->nwords))) {
+        munmap(map, sb.st_size);
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((d = malloc(sizeof(*d))) == NULL) {
+        munmap(map, sb.st_size);
+        errno = ENOMEM;
+        return NULL;
+    }
+    d->hdr = h;
+    d->mapsize = sb.st_size;
+    d->off = (const uint32_t *)((const char *)map + h->off_off);
+    d->len = (const uint8_t *)map + h->len_off;
+    d->text = (const char *)map + h->text_off;
+    d->pilot = d->slot = NULL;
+    if (h->flags & DICT_F_MPH) {
+        d->pilot = (const uint32_t *)((const char *)map + h->pilot_off);
+        d->slot = (const uint32_t *)((const char *)map + h->slot_off);
+    }
+    d->nwords = h->nwords;
+    d->maxlen = h->maxlen;
+    d->sample_bits = h->sample_bits;
+    d->sample_reject = h->sample_reject;
+    return d;
+}
+
+void
+mkpasswd_dict_close(mkpasswd_dict *d) {
+    if (d == NULL)
+        return;
+    munmap((void *)d->hdr, d->mapsize);
+    free(d);
+}
+
+void
+mkpasswd_set_dict(mkpasswd_ctx *ctx, const mkpasswd_dict *d) {
+    ctx_lock(ctx);
+    ctx->dict = d;
+    ctx_unlock(ctx);
+}
+
+size_t
+mkpasswd_dict_words(const mkpasswd_dict *d) {
+    return d != NULL ? d->nwords : NWORDS;
+}
+
+/*
+ *  What mkdict reports for the built-in table: every word is
+ *  capitalized, so the capitals mark the boundaries, but a word
+ *  such as "Abe" is a prefix of another ("Abed"), so they are
+ *  lost when case is.
+ */
+static const struct mkpasswd_dict_info builtin_info = {
+    NWORDS, 3, WORD_MAX, 11.0, 1, 1, 0, 1
+};
+
+void
+mkpasswd_dict_get_info(const mkpasswd_dict *d,
+    struct mkpasswd_dict_info *info) {
+    if (d == NULL) {
+        *info = builtin_info;
+        return;
+    }
+    info->words = d->nwords;
+    info->minlen = d->hdr->minlen;
+    info->maxlen = d->maxlen;
+    info->bits = d->hdr->bits;
+    info->unique = (d->hdr->flags & DICT_F_UNIQUE) != 0;
+    info->decodable = (d->hdr->flags & DICT_F_DECODABLE) != 0;
+    info->decodable_nocase = (d->hdr->flags & DICT_F_DECODABLE_NOCASE) != 0;
+    info->hashed = d->pilot != NULL;
+}
+
+size_t
+mkpasswd_dict_batch_size(const mkpasswd_dict *d, size_t count,
+    unsigned nwords) {
+    return count * nwords * ((d != NULL ? d->maxlen : WORD_MAX) + 1) +
+        ASSEMBLE_SLACK;
+}
+
+double
+mkpasswd_dict_entropy_bits(const mkpasswd_dict *d, unsigned nwords) {
+    return nwords * (d != NULL ? d->hdr->bits : builtin_info.bits);
+}
+
+
+/*
+ *  Decoding.  Each word is found through the perfect hash and then
+ *  compared, case folded, with the word the hash names.
+ */
+static long
+lookup(const struct mkpasswd_dict *d, const char *s, size_t len) {
+    const char  *w;
+    uint64_t    h;
+    uint32_t    i;
+    size_t      k, wl;
+
+    if (d == NULL) {
+        if (len < 3 || len > WORD_MAX)
+            return -1;
+        h = dict_hash(s, len, MPH_SEED);
+        i = mph_slot[dict_slot(h, mph_pilot[dict_bucket(h, MPH_BUCKETS)],
+            NWORDS)];
+        w = words[i];
+        wl = wordlen(i);
+    } else {
+        if (len < d->hdr->minlen || len > d->maxlen)
+            return -1;
+        h = dict_hash(s, len, d->hdr->mph_seed);
+        i = d->slot[dict_slot(h,
+            d->pilot[dict_bucket(h, d->hdr->mph_buckets)], d->nwords)];
+        if (i >= d->nwords || d->off[i] > d->hdr->text_len)
+            return -1;
+        w = d->text + d->off[i];
+        wl = d->len[i];
+    }
+    if (wl != len)
+        return -1;
+    for (k = 0; k < len; k++)
+        if (dict_fold(w[k]) != dict_fold(s[k]))
+            return -1;
+    return i;
+}
+
+#define	DECODE_TOKEN_MAX	1024
+
+struct decoder {
+    const struct mkpasswd_dict  *d;
+    unsigned                    minlen, maxlen;
+    uint32_t                    *idx;
+    size_t                      n, max;
+    size_t                      tn;         /* words in tok[] */
+    size_t                      hw;         /* tok[] used, to wipe */
+    uint32_t                    tok[DECODE_TOKEN_MAX];
+    uint8_t                     dead[DECODE_TOKEN_MAX];
+};
+
+/*
+ *  Split s[pos..len) into words, longest first, backing up when a
+ *  choice leads nowhere; dead[] remembers positions from which no
+ *  split exists, so no position is tried twice.
+ */
+static int
+segment(struct decoder *dc, const char *s, size_t pos, size_t len) {
+    size_t      l, top;
+    long        i;
+
+    if (pos == len)
+        return 1;
+    if (dc->dead[pos])
+        return 0;
+    top = len - pos < dc->maxlen ? len - pos : dc->maxlen;
+    for (l = top; l >= dc->minlen && l > 0; l--)
+        if ((i = lookup(dc->d, s + pos, l)) >= 0) {
+            dc->tok[dc->tn++] = i;
+            if (dc->tn > dc->hw)
+                dc->hw = dc->tn;
+            if (segment(dc, s, pos + l, len))
+                return 1;
+            dc->tn--;
+        }
+    dc->dead[pos] = 1;
+    return 0;
+}
+
+/*
+ *  One run of letters without separators.  Capitals mark the word
+ *  starts in what mkpasswd prints, so they are tried first; the
+ *  search above covers text whose case has been lost.
+ */
+static int
+decode_token(struct decoder *dc, const char *s, size_t len) {
+    size_t      a, b;
+    long        i;
+
+    if (len > DECODE_TOKEN_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+    dc->tn = 0;
+    for (a = 0; a < len; a = b) {
+        for (b = a + 1; b < len && (unsigned)(s[b] - 'A') >= 26u; b++)
+            ;
+        if ((i = lookup(dc->d, s + a, b - a)) < 0)
+            break;
+        dc->tok[dc->tn++] = i;
+        if (dc->tn > dc->hw)
+            dc->hw = dc->tn;
+    }
+    if (a < len) {
+        dc->tn = 0;
+        memset(dc->dead, 0, len);
+        if (!segment(dc, s, 0, len)) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    if (dc->max - dc->n < dc->tn) {
+        errno = ERANGE;
+        return -1;
+    }
+    memcpy(dc->idx + dc->n, dc->tok, dc->tn * sizeof(dc->tok[0]));
+    dc->n += dc->tn;
+    return 0;
+}
+
+static inline int
+is_sep(unsigned char c) {
+    return c < 0x80 && !((unsigned)(c - '0') < 10u ||
+        (unsigned)(dict_fold(c) - 'a') < 26u);
+}
+
+ssize_t
+mkpasswd_decode(const mkpasswd_dict *d, const char *phrase, size_t len,
+    uint32_t *idx, size_t maxwords) {
+    struct decoder  dc;
+    size_t          a, b;
+
+    if (d != NULL && d->pilot == NULL) {
+        errno = ENOTSUP;
+        return -1;
+    }
+    dc.d = d;
+    dc.minlen = d != NULL ? d->hdr->minlen : 3;
+    dc.maxlen = d != NULL ? d->maxlen : WORD_MAX;
+    dc.idx = idx;
+    dc.n = 0;
+    dc.max = maxwords;
+    dc.hw = 0;
+    for (a = 0; a < len; a = b) {
+        for (; a < len && is_sep(phrase[a]); a++)
+            ;
+        for (b = a; b < len && !is_sep(phrase[b]); b++)
+            ;
+        if (b > a && decode_token(&dc, phrase + a, b - a) != 0)
+            break;
+    }
+    wipe(dc.tok, dc.hw * sizeof(dc.tok[0]));
+    if (a < len)
+        return -1;
+    if (dc.n == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    return dc.n;
+}
+
+/*
+ *  Pool of ready-made phrases.  The producer thread is the only
+ *  writer of head; consumers claim slots by advancing tail with a
+ *  compare-and-swap.  Each slot carries a sequence number so that
+ *  neither side touches a slot the other is still copying:  seq ==
+ *  pos means free for the producer at pos, seq == pos + 1 means
+ *  full for the consumer at pos.
+ */
+#define	POOL_DEFAULT	4096
+#define	POOL_BATCH	256
+#define	CACHELINE	64
+
+struct pool_slot {
+    size_t          seq;
+    uint16_t        len;
+    char            text[];         /* stride - sizeof(struct pool_slot) */
+};
+
+struct mkpasswd_pool {
+    size_t              head __attribute__((aligned(CACHELINE)));
+    size_t              tail __attribute__((aligned(CACHELINE)));
+    unsigned long long  hits, stalls;
+    int                 sleeping __attribute__((aligned(CACHELINE)));
+    int                 running;
+    int                 error;
+    unsigned char       *slots;
+    size_t              stride, mask, high, low;
+    char                *batch;
+    size_t              batchsize;
+    unsigned            nwords;
+    char                sep;
+    unsigned long long  produced, wakeups;
+    pthread_mutex_t     mu;
+    pthread_cond_t      cv;
+    pthread_t           tid;
+    mkpasswd_ctx        ctx;            /* the producer's */
+    mkpasswd_ctx        spare;          /* for consumers on a stall */
+};
+
+static inline struct pool_slot *
+pool_slot(const mkpasswd_pool *p, size_t pos) {
+    return (struct pool_slot *)(p->slots + (pos & p->mask) * p->stride);
+}
+
+static void *
+pool_fill(void *arg) {
+    mkpasswd_pool   *p = arg;
+    char            *batch = p->batch;
+    struct pool_slot *s;
+    const char      *q, *nl;
+    size_t          head = 0, level, n, i;
+    ssize_t         len;
+
+    while (__atomic_load_n(&p->running, __ATOMIC_RELAXED)) {
+        level = head - __atomic_load_n(&p->tail, __ATOMIC_SEQ_CST);
+        if (level >= p->high) {
+            pthread_mutex_lock(&p->mu);
+            __atomic_store_n(&p->sleeping, 1, __ATOMIC_SEQ_CST);
+            while (__atomic_load_n(&p->running, __ATOMIC_RELAXED) &&
+                head - __atomic_load_n(&p->tail, __ATOMIC_SEQ_CST) > p->low)
+                pthread_cond_wait(&p->cv, &p->mu);
+            __atomic_store_n(&p->sleeping, 0, __ATOMIC_RELAXED);
+            p->wakeups++;
+            pthread_mutex_unlock(&p->mu);
+            continue;
+        }
+        n = p->high - level;
+        if (n > POOL_BATCH)
+            n = POOL_BATCH;
+        ctx_lock(&p->ctx);
+        len = generate(&p->ctx, batch, n, p->nwords, p->sep, NULL,
+            NULL);
+        ctx_unlock(&p->ctx);
+        if (len < 0) {
+            __atomic_store_n(&p->error, errno, __ATOMIC_RELAXED);
+            break;
+        }
+        for (q = batch, i = 0; i < n; i++, q = nl + 1, head++) {
+            s = pool_slot(p, head);
+            /* a consumer may still be copying out the previous lap */
+            while (__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != head)
+                sched_yield();
+            nl = memchr(q, '\n', batch + len - q);
+            s->len = nl - q;
+            memcpy(s->text, q, s->len);
+            __atomic_store_n(&s->seq, head + 1, __ATOMIC_RELEASE);
+            __atomic_store_n(&p->head, head + 1, __ATOMIC_RELEASE);
+        }
+        __atomic_store_n(&p->produced, p->produced + n, __ATOMIC_RELAXED);
+        wipe(batch, len);
+    }
+    wipe(batch, p->batchsize);
+    return NULL;
+}
+
+mkpasswd_pool *
+mkpasswd_pool_create(const struct mkpasswd_pool_conf *conf) {
+    mkpasswd_pool   *p;
+    size_t          high, low, cap, i;
+    unsigned        nctx = 0;
+
+    high = conf->high ? conf->high : POOL_DEFAULT;
+    low = conf->low ? conf->low : high / 2;
+    if (conf->nwords < 1 || conf->nwords > MKPASSWD_MAX_WORDS ||
+        low >= high || high > SIZE_MAX / 2 / 4096) {
+        errno = EINVAL;
+        return NULL;
+    }
+    for (cap = 1; cap < high; cap <<= 1)
+        ;
+    /* page-aligned, as the head and tail must be cache-aligned */
+    if ((p = mkpasswd_secure_alloc(sizeof(*p))) == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    /* room for the longest phrase, less its newline, plus a NUL */
+    p->stride = (sizeof(struct pool_slot) +
+        mkpasswd_dict_batch_size(conf->dict, 1, conf->nwords) -
+        ASSEMBLE_SLACK + 15) & ~(size_t)15;
+    p->batchsize = mkpasswd_dict_batch_size(conf->dict, POOL_BATCH,
+        conf->nwords);
+    if ((p->slots = mkpasswd_secure_alloc(cap * p->stride)) == NULL ||
+        (p->batch = mkpasswd_secure_alloc(p->batchsize)) == NULL) {
+        mkpasswd_secure_free(p->slots, cap * p->stride);
+        mkpasswd_secure_free(p, sizeof(*p));
+        errno = ENOMEM;
+        return NULL;
+    }
+    p->mask = cap - 1;
+    for (i = 0; i < cap; i++)
+        pool_slot(p, i)->seq = i;
+    p->high = high;
+    p->low = low;
+    p->nwords = conf->nwords;
+    p->sep = conf->sep;
+    p->running = 1;
+    if (mkpasswd_init(&p->ctx, conf->flags, NULL, 0) != 0)
+        goto bad;
+    nctx++;
+    if (mkpasswd_init(&p->spare, conf->flags, NULL, 0) != 0)
+        goto bad;
+    nctx++;
+    if (conf->kernel != NULL &&
+        (mkpasswd_set_kernel(&p->ctx, conf->kernel) != 0 ||
+        mkpasswd_set_kernel(&p->spare, conf->kernel) != 0))
+        goto bad;
+    mkpasswd_set_dict(&p->ctx, conf->dict);
+    mkpasswd_set_dict(&p->spare, conf->dict);
+    mkpasswd_set_reseed(&p->ctx, conf->reseed);
+    mkpasswd_set_reseed(&p->spare, conf->reseed);
+    if (mkpasswd_set_prefetch(&p->ctx, conf->prefetch) != 0)
+        goto bad;
+    pthread_mutex_init(&p->mu, NULL);
+    pthread_cond_init(&p->cv, NULL);
+    if ((errno = pthread_create(&p->tid, NULL, pool_fill, p)) != 0) {
+        pthread_cond_destroy(&p->cv);
+        pthread_mutex_destroy(&p->mu);
+        goto bad;
+    }
+    return p;
+
+bad:
+    i = errno;
+    /* only those set up: a zeroed context's fd would be stdin */
+    if (nctx > 1)
+        mkpasswd_destroy(&p->spare);
+    if (nctx > 0)
+        mkpasswd_destroy(&p->ctx);
+    mkpasswd_secure_free(p->batch, p->batchsize);
+    mkpasswd_secure_free(p->slots, cap * p->stride);
+    mkpasswd_secure_free(p, sizeof(*p));
+    errno = i;
+    return NULL;
+}
+
+void
+mkpasswd_pool_destroy(mkpasswd_pool *p) {
+    pthread_mutex_lock(&p->mu);
+    __atomic_store_n(&p->running, 0, __ATOMIC_RELAXED);
+    pthread_cond_signal(&p->cv);
+    pthread_mutex_unlock(&p->mu);
+    pthread_join(p->tid, NULL);
+    pthread_cond_destroy(&p->cv);
+    pthread_mutex_destroy(&p->mu);
+    mkpasswd_secure_free(p->slots, (p->mask + 1) * p->stride);
+    mkpasswd_secure_free(p->batch, p->batchsize);
+    mkpasswd_destroy(&p->ctx);
+    mkpasswd_destroy(&p->spare);
+    mkpasswd_secure_free(p, sizeof(*p));
+}
+
+ssize_t
+mkpasswd_pool_get(mkpasswd_pool *p, char *out, size_t outlen) {
+    struct pool_slot *s;
+    size_t          pos, len;
+
+    pos = __atomic_load_n(&p->tail, __ATOMIC_RELAXED);
+    for (;;) {
+        s = pool_slot(p, pos);
+        if (__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != pos + 1) {
+            if (pos != __atomic_load_n(&p->tail, __ATOMIC_RELAXED)) {
+                pos = __atomic_load_n(&p->tail, __ATOMIC_RELAXED);
+                continue;
+            }
+            /* empty: make one here, and make sure the producer is up */
+            __atomic_fetch_add(&p->stalls, 1, __ATOMIC_RELAXED);
+            if (__atomic_load_n(&p->sleeping, __ATOMIC_SEQ_CST)) {
+                pthread_mutex_lock(&p->mu);
+                pthread_cond_signal(&p->cv);
+                pthread_mutex_unlock(&p->mu);
+            }
+            return mkpasswd_generate(&p->spare, out, outlen, p->nwords,
+                p->sep);
+        }
+        if (__atomic_compare_exchange_n(&p->tail, &pos, pos + 1, 0,
+            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            break;
+    }
+    len = s->len;
+    if (len < outlen) {
+        memcpy(out, s->text, len);
+        out[len] = '\0';
+    }
+    wipe(s->text, len);
+    s->len = 0;
+    __atomic_store_n(&s->seq, pos + p->mask + 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&p->hits, 1, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&p->head, __ATOMIC_RELAXED) - (pos + 1) <= p->low &&
+        __atomic_load_n(&p->sleeping, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&p->mu);
+        pthread_cond_signal(&p->cv);
+        pthread_mutex_unlock(&p->mu);
+    }
+    if (len >= outlen) {
+        errno = ERANGE;
+        return -1;
+    }
+    return len;
+}
+
+void
+mkpasswd_pool_get_stats(mkpasswd_pool *p, struct mkpasswd_pool_stats *st) {
+    st->hits = __atomic_load_n(&p->hits, __ATOMIC_RELAXED);
+    st->stalls = __atomic_load_n(&p->stalls, __ATOMIC_RELAXED);
+    st->produced = __atomic_load_n(&p->produced, __ATOMIC_RELAXED);
+    st->prefetch_stalls = 0;
+    if (p->ctx.prefetch != NULL) {
+        pthread_mutex_lock(&p->ctx.prefetch->mu);
+        st->prefetch_stalls = p->ctx.prefetch->stalls;
+        pthread_mutex_unlock(&p->ctx.prefetch->mu);
+    }
+    pthread_mutex_lock(&p->mu);
+    st->wakeups = p->wakeups;
+    pthread_mutex_unlock(&p->mu);
+    /* tail first, so that the difference cannot go negative */
+    st->level = __atomic_load_n(&p->tail, __ATOMIC_ACQUIRE);
+    st->level = __atomic_load_n(&p->head, __ATOMIC_ACQUIRE) - st->level;
+    st->error = __atomic_load_n(&p->error, __ATOMIC_RELAXED);
+}
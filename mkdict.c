@@ -0,0 +1,850 @@
+/*
+ *    Copyright (c) 2013 Michael Sierchio
+ *    
+ *    All rights reserved.
+ *    
+ *    Redistribution and use in source and binary forms, with or
+ *    without modification, are permitted provided that the
+ *    following conditions are met:
+ *    
+ *    1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer.
+ *    
+ *    2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *    
+ *    THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS
+ *    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+ *    SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *    OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ *    THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ *    OF SUCH DAMAGE.
+ */
+
+
+/*
+ *  mkdict:     compile a word list for mkpasswd -f
+ *
+ *          To compile:    make mkdict
+ *
+ *          Reads a word list, one word per line, and writes it in
+ *          the format described in dict.h, which mkpasswd maps as
+ *          it stands instead of parsing text on every run.  Blank
+ *          lines and lines starting with '#' are skipped; where a
+ *          line has several fields, the last one is the word, so
+ *          diceware lists ("11111 abacus") can be used unedited.
+ *          The first letter of each word is capitalized, as in the
+ *          built-in list, unless -k is given.
+ *
+ *          Everything mkpasswd might want to know about the list
+ *          is settled here, once, and stored in the header:
+ *          duplicates are dropped (they would make some words
+ *          likelier than others), the bits per word are worked
+ *          out, and the Sardinas-Patterson test decides whether
+ *          phrases run together without a separator can always be
+ *          split back into words, both as written and with case
+ *          ignored.  If they cannot, distinct index sequences may
+ *          give the same text, and separatorless phrases carry
+ *          less entropy than the nominal figure.
+ *
+ *          A minimal perfect hash of the words, case folded, is
+ *          searched for here too, so that mkpasswd --decode can look
+ *          each word up in constant time.
+ *
+ *          With -c the list is written as C tables instead, which
+ *          is how words.txt becomes words.h: the word slots, the
+ *          length bitmap, the kernels' byte shuffles and the hash,
+ *          laid out once at build time rather than kept in step by
+ *          hand or built at start-up.
+ *
+ *          The output is written beside the target and renamed
+ *          into place, so programs that have the old dictionary
+ *          mapped keep seeing it whole.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "dict.h"
+
+
+struct wordlist {
+    char        *text;
+    size_t      textlen, textsize;
+    uint32_t    *off;
+    uint8_t     *len;
+    size_t      n, size;
+    unsigned    minlen, maxlen;
+};
+
+
+static void fail(const char *) __attribute__((__noreturn__));
+
+static void
+fail(const char *what) {
+    int     err = errno != 0 ? errno : EIO;
+
+    fprintf(stderr, "mkdict : %s: %s\n", what, strerror(err));
+    exit(err);
+}
+
+static void *
+xrealloc(void *p, size_t n) {
+    if ((p = realloc(p, n)) == NULL) {
+        fprintf(stderr, "mkdict : out of memory\n");
+        exit(ENOMEM);
+    }
+    return p;
+}
+
+static void
+add_word(struct wordlist *wl, const char *w, size_t len, int keepcase,
+    unsigned long line) {
+    if (len > DICT_WORD_MAX) {
+        fprintf(stderr, "mkdict : line %lu: word longer than %d bytes\n",
+            line, DICT_WORD_MAX);
+        exit(EINVAL);
+    }
+    if (wl->n == DICT_MAX_WORDS) {
+        fprintf(stderr, "mkdict : more than %u words\n", DICT_MAX_WORDS);
+        exit(EINVAL);
+    }
+    if (wl->n == wl->size) {
+        wl->size = wl->size ? wl->size * 2 : 4096;
+        wl->off = xrealloc(wl->off, (wl->size + 1) * sizeof(*wl->off));
+        wl->len = xrealloc(wl->len, wl->size * sizeof(*wl->len));
+    }
+    if (wl->textsize - wl->textlen < len) {
+        while (wl->textsize - wl->textlen < len)
+            wl->textsize = wl->textsize ? wl->textsize * 2 : 65536;
+        wl->text = xrealloc(wl->text, wl->textsize);
+    }
+    if (wl->textlen + len > UINT32_MAX) {
+        fprintf(stderr, "mkdict : word list too large\n");
+        exit(EINVAL);
+    }
+    wl->off[wl->n] = wl->textlen;
+    wl->len[wl->n] = len;
+    memcpy(wl->text + wl->textlen, w, len);
+    if (!keepcase)
+        wl->text[wl->textlen] = toupper((unsigned char)w[0]);
+    wl->textlen += len;
+    if (wl->n == 0 || len < wl->minlen)
+        wl->minlen = len;
+    if (len > wl->maxlen)
+        wl->maxlen = len;
+    wl->n++;
+}
+
+/*
+ *  Word order: by bytes, or with case folded.  qsort() takes no
+ *  argument for the comparison, hence the statics.
+ */
+static const struct wordlist    *sort_wl;
+static int                      sort_fold;
+
+static int
+strcmp_n(const char *a, size_t al, const char *b, size_t bl, int fold) {
+    size_t      i, n = al < bl ? al : bl;
+    int         ca, cb;
+
+    for (i = 0; i < n; i++) {
+        ca = (unsigned char)a[i];
+        cb = (unsigned char)b[i];
+        if (fold) {
+            ca = tolower(ca);
+            cb = tolower(cb);
+        }
+        if (ca != cb)
+            return ca - cb;
+    }
+    return al < bl ? -1 : al > bl;
+}
+
+static int
+word_cmp(const void *a, const void *b) {
+    uint32_t    i = *(const uint32_t *)a, j = *(const uint32_t *)b;
+    int         c;
+
+    c = strcmp_n(sort_wl->text + sort_wl->off[i], sort_wl->len[i],
+        sort_wl->text + sort_wl->off[j], sort_wl->len[j], sort_fold);
+    /* equal words: keep list order, so the first one survives */
+    return c != 0 ? c : (i > j) - (i < j);
+}
+
+static uint32_t *
+sorted(const struct wordlist *wl, int fold) {
+    uint32_t    *order = xrealloc(NULL, wl->n * sizeof(*order));
+    size_t      i;
+
+    for (i = 0; i < wl->n; i++)
+        order[i] = i;
+    sort_wl = wl;
+    sort_fold = fold;
+    qsort(order, wl->n, sizeof(*order), word_cmp);
+    return order;
+}
+
+/*
+ *  Remove repeated words, keeping the first of each, and say how
+ *  many went.
+ */
+static size_t
+drop_duplicates(struct wordlist *wl) {
+    uint32_t    *order = sorted(wl, 0);
+    uint8_t     *dup = xrealloc(NULL, wl->n);
+    size_t      i, j, o, ndup = 0;
+
+    memset(dup, 0, wl->n);
+    for (i = 1; i < wl->n; i++)
+        if (strcmp_n(wl->text + wl->off[order[i]], wl->len[order[i]],
+            wl->text + wl->off[order[i-1]], wl->len[order[i-1]], 0) == 0) {
+            dup[order[i]] = 1;
+            fprintf(stderr, "mkdict : duplicate word %.*s dropped\n",
+                (int)wl->len[order[i]], wl->text + wl->off[order[i]]);
+            ndup++;
+        }
+    for (i = j = o = 0; i < wl->n; i++) {
+        if (dup[i])
+            continue;
+        memmove(wl->text + o, wl->text + wl->off[i], wl->len[i]);
+        wl->off[j] = o;
+        wl->len[j] = wl->len[i];
+        o += wl->len[i];
+        j++;
+    }
+    wl->n = j;
+    wl->textlen = o;
+    free(dup);
+    free(order);
+    return ndup;
+}
+
+/*
+ *  Index into order of the word equal to s, or -1.
+ */
+static long
+find(const struct wordlist *wl, const uint32_t *order, int fold,
+    const char *s, size_t len) {
+    size_t      lo = 0, hi = wl->n, mid;
+    int         c;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        c = strcmp_n(wl->text + wl->off[order[mid]], wl->len[order[mid]],
+            s, len, fold);
+        if (c == 0)
+            return mid;
+        if (c < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return -1;
+}
+
+/*
+ *  First index into order of a word not below s; the words that
+ *  start with s follow from there.
+ */
+static size_t
+lower_bound(const struct wordlist *wl, const uint32_t *order, int fold,
+    const char *s, size_t len) {
+    size_t      lo = 0, hi = wl->n, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (strcmp_n(wl->text + wl->off[order[mid]], wl->len[order[mid]],
+            s, len, fold) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/*
+ *  Sardinas-Patterson.  A dangling suffix is what is left of one
+ *  word after another word, or a chain of them, has been matched
+ *  against its start; the list is uniquely decodable unless some
+ *  dangling suffix is itself a word.  Every suffix is the tail of
+ *  a word in the text, so it is named by its text position, and
+ *  each is followed up once.
+ */
+struct sp_state {
+    const struct wordlist   *wl;
+    const uint32_t          *order;
+    int                     fold;
+    uint8_t                 *seen;
+    uint32_t                *qpos;
+    uint8_t                 *qlen;
+    size_t                  qn;
+};
+
+static void
+sp_push(struct sp_state *sp, uint32_t pos, size_t len) {
+    if (sp->seen[pos])
+        return;
+    sp->seen[pos] = 1;
+    sp->qpos[sp->qn] = pos;
+    sp->qlen[sp->qn] = len;
+    sp->qn++;
+}
+
+/* queue the suffixes left by words that are proper prefixes of s */
+static void
+sp_prefixes(struct sp_state *sp, uint32_t pos, size_t len) {
+    const struct wordlist   *wl = sp->wl;
+    size_t                  l;
+
+    for (l = wl->minlen; l < len; l++)
+        if (find(wl, sp->order, sp->fold, wl->text + pos, l) >= 0)
+            sp_push(sp, pos + l, len - l);
+}
+
+static int
+decodable(const struct wordlist *wl, int fold) {
+    struct sp_state     sp;
+    const char          *s;
+    size_t              i, k, len;
+    uint32_t            w, pos;
+    int                 ok = 1;
+
+    sp.wl = wl;
+    sp.order = sorted(wl, fold);
+    sp.fold = fold;
+    sp.seen = xrealloc(NULL, wl->textlen);
+    sp.qpos = xrealloc(NULL, wl->textlen * sizeof(*sp.qpos));
+    sp.qlen = xrealloc(NULL, wl->textlen);
+    sp.qn = 0;
+    memset(sp.seen, 0, wl->textlen);
+
+    for (i = 0; i < wl->n; i++)
+        sp_prefixes(&sp, wl->off[i], wl->len[i]);
+    for (k = 0; k < sp.qn && ok; k++) {
+        pos = sp.qpos[k];
+        len = sp.qlen[k];
+        s = wl->text + pos;
+        if (find(wl, sp.order, fold, s, len) >= 0) {
+            ok = 0;
+            break;
+        }
+        sp_prefixes(&sp, pos, len);
+        /* and those left when s is a proper prefix of a word */
+        for (i = lower_bound(wl, sp.order, fold, s, len); i < wl->n; i++) {
+            w = sp.order[i];
+            if (wl->len[w] <= len ||
+                strcmp_n(wl->text + wl->off[w], len, s, len, fold) != 0)
+                break;
+            sp_push(&sp, wl->off[w] + len, wl->len[w] - len);
+        }
+    }
+    free((void *)sp.order);
+    free(sp.seen);
+    free(sp.qpos);
+    free(sp.qlen);
+    return ok;
+}
+
+/*
+ *  Minimal perfect hash, as described in dict.h.  Buckets are
+ *  placed largest first, each with the smallest pilot that sends
+ *  all its keys to free slots; if a bucket runs out of pilots, or
+ *  two of its keys hash alike, start over with another seed.  A
+ *  fixed seed sequence keeps the output reproducible.
+ */
+#define	MPH_LAMBDA	4		/* keys per bucket, on average */
+#define	MPH_TRIES	64
+#define	MPH_MAX_PILOT	(1u << 24)
+
+struct mph {
+    uint64_t    seed;
+    uint32_t    nbuckets;
+    uint32_t    *pilot;
+    uint32_t    *slot;
+};
+
+static int
+mph_try(const struct wordlist *wl, struct mph *m, uint64_t seed) {
+    uint64_t    *h = xrealloc(NULL, wl->n * sizeof(*h));
+    uint32_t    *start, *keys, *order, *size_start, *bkt_slots;
+    uint8_t     *taken;
+    uint32_t    nb = (wl->n + MPH_LAMBDA - 1) / MPH_LAMBDA, b, i, j, k;
+    uint32_t    p, maxsize = 0, bs, s;
+    int         ok = 1;
+
+    m->seed = seed;
+    m->nbuckets = nb;
+    start = xrealloc(NULL, (nb + 1) * sizeof(*start));
+    keys = xrealloc(NULL, wl->n * sizeof(*keys));
+    order = xrealloc(NULL, nb * sizeof(*order));
+    taken = xrealloc(NULL, wl->n);
+    memset(start, 0, (nb + 1) * sizeof(*start));
+    memset(taken, 0, wl->n);
+    memset(m->pilot, 0, nb * sizeof(*m->pilot));
+
+    /* keys grouped by bucket: start[b] .. start[b + 1] in keys */
+    for (i = 0; i < wl->n; i++) {
+        h[i] = dict_hash(wl->text + wl->off[i], wl->len[i], seed);
+        start[dict_bucket(h[i], nb) + 1]++;
+    }
+    for (b = 0; b < nb; b++) {
+        if (start[b + 1] > maxsize)
+            maxsize = start[b + 1];
+        start[b + 1] += start[b];
+    }
+    /* fill each bucket from its end; start[b + 1] ends at its start */
+    for (i = 0; i < wl->n; i++) {
+        b = dict_bucket(h[i], nb);
+        keys[--start[b + 1]] = i;
+    }
+    for (b = 0; b < nb; b++)
+        start[b] = start[b + 1];
+    start[nb] = wl->n;
+
+    /* buckets by size, largest first */
+    size_start = xrealloc(NULL, (maxsize + 2) * sizeof(*size_start));
+    memset(size_start, 0, (maxsize + 2) * sizeof(*size_start));
+    for (b = 0; b < nb; b++)
+        size_start[maxsize - (start[b + 1] - start[b]) + 1]++;
+    for (s = 0; s <= maxsize; s++)
+        size_start[s + 1] += size_start[s];
+    for (b = 0; b < nb; b++)
+        order[size_start[maxsize - (start[b + 1] - start[b])]++] = b;
+
+    bkt_slots = xrealloc(NULL, (maxsize + 1) * sizeof(*bkt_slots));
+    for (i = 0; i < nb && ok; i++) {
+        b = order[i];
+        bs = start[b + 1] - start[b];
+        if (bs == 0)
+            break;
+        for (p = 0; p < MPH_MAX_PILOT; p++) {
+            for (j = 0; j < bs; j++) {
+                s = dict_slot(h[keys[start[b] + j]], p, wl->n);
+                if (taken[s])
+                    break;
+                for (k = 0; k < j && bkt_slots[k] != s; k++)
+                    ;
+                if (k < j)
+                    break;
+                bkt_slots[j] = s;
+            }
+            if (j == bs)
+                break;
+        }
+        if (p == MPH_MAX_PILOT) {
+            ok = 0;
+            break;
+        }
+        m->pilot[b] = p;
+        for (j = 0; j < bs; j++) {
+            taken[bkt_slots[j]] = 1;
+            m->slot[bkt_slots[j]] = keys[start[b] + j];
+        }
+    }
+    free(h);
+    free(start);
+    free(keys);
+    free(order);
+    free(taken);
+    free(size_start);
+    free(bkt_slots);
+    return ok;
+}
+
+/*
+ *  Words that are equal with case folded cannot be told apart by
+ *  a case-blind lookup, and get no hash.
+ */
+static int
+mph_build(const struct wordlist *wl, struct mph *m) {
+    uint32_t    *order = sorted(wl, 1);
+    size_t      i;
+    int         t;
+
+    for (i = 1; i < wl->n; i++)
+        if (strcmp_n(wl->text + wl->off[order[i]], wl->len[order[i]],
+            wl->text + wl->off[order[i-1]], wl->len[order[i-1]], 1) == 0) {
+            free(order);
+            return 0;
+        }
+    free(order);
+    m->pilot = xrealloc(NULL, ((wl->n + MPH_LAMBDA - 1) / MPH_LAMBDA) *
+        sizeof(*m->pilot));
+    m->slot = xrealloc(NULL, wl->n * sizeof(*m->slot));
+    for (t = 0; t < MPH_TRIES; t++)
+        if (mph_try(wl, m, 0x6d6b7061737377ULL + t * 0x9e3779b97f4a7c15ULL))
+            return 1;
+    free(m->pilot);
+    free(m->slot);
+    return 0;
+}
+
+static void
+read_words(struct wordlist *wl, FILE *fp, int keepcase) {
+    char            line[1024], *p, *w, *e;
+    unsigned long   lineno = 0;
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        lineno++;
+        if (strchr(line, '\n') == NULL && !feof(fp)) {
+            fprintf(stderr, "mkdict : line %lu: too long\n", lineno);
+            exit(EINVAL);
+        }
+        e = line + strlen(line);
+        while (e > line && isspace((unsigned char)e[-1]))
+            *--e = '\0';
+        for (p = line; isspace((unsigned char)*p); p++)
+            ;
+        if (*p == '\0' || *p == '#')
+            continue;
+        for (w = p; *p != '\0'; p++)
+            if (isspace((unsigned char)*p))
+                w = p + 1;
+        add_word(wl, w, e - w, keepcase, lineno);
+    }
+    if (ferror(fp))
+        fail("read error");
+}
+
+static uint64_t
+align(uint64_t v) {
+    return (v + DICT_ALIGN - 1) & ~(uint64_t)(DICT_ALIGN - 1);
+}
+
+static void
+put(FILE *fp, const void *p, size_t n, uint64_t at) {
+    static const char   zero[DICT_ALIGN];
+    long                pos = ftell(fp);
+
+    /* pad up to the section start */
+    if (pos >= 0 && (uint64_t)pos < at)
+        fwrite(zero, 1, at - pos, fp);
+    if (n != 0)
+        fwrite(p, 1, n, fp);
+}
+
+static FILE *
+create(const char *path, char **tmp) {
+    FILE        *fp;
+    size_t      n;
+
+    n = strlen(path) + sizeof(".tmp");
+    *tmp = xrealloc(NULL, n);
+    snprintf(*tmp, n, "%s.tmp", path);
+    if ((fp = fopen(*tmp, "wb")) == NULL)
+        fail(*tmp);
+    return fp;
+}
+
+static void
+commit(FILE *fp, char *tmp, const char *path) {
+    if (fflush(fp) != 0 || ferror(fp) || fsync(fileno(fp)) != 0) {
+        unlink(tmp);
+        fail(tmp);
+    }
+    if (fclose(fp) != 0 || rename(tmp, path) != 0) {
+        unlink(tmp);
+        fail(path);
+    }
+    free(tmp);
+}
+
+/*
+ *  Width of the draw for a word, as described in dict.h: a wider
+ *  draw costs more bits but is rejected less often, so take the
+ *  one with the fewest bits drawn per word on average, w * 2^w /
+ *  (2^w - 2^w % n).  Returns the expected cost.
+ */
+static double
+sample_width(uint32_t n, uint32_t *bits, uint32_t *reject) {
+    uint64_t    r;
+    double      cost, best = 0;
+    unsigned    w;
+
+    for (w = 1; (1ULL << w) < n; w++)
+        ;
+    for (; w <= 32; w++) {
+        r = (1ULL << w) % n;
+        cost = w * ldexp(1, w) / (ldexp(1, w) - r);
+        if (best == 0 || cost < best) {
+            best = cost;
+            *bits = w;
+            *reject = (uint32_t)r;
+        }
+    }
+    return best;
+}
+
+static void
+write_dict(const struct wordlist *wl, uint32_t flags, const struct mph *m,
+    const char *path) {
+    static const char   pad[DICT_PAD];
+    struct dict_header  h;
+    char                *tmp;
+    FILE                *fp;
+
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, DICT_MAGIC, sizeof(h.magic));
+    h.version = DICT_VERSION;
+    h.byteorder = DICT_BYTEORDER;
+    h.nwords = wl->n;
+    h.minlen = wl->minlen;
+    h.maxlen = wl->maxlen;
+    h.flags = flags;
+    sample_width(wl->n, &h.sample_bits, &h.sample_reject);
+    h.bits = log2((double)wl->n);
+    h.off_off = align(sizeof(h));
+    h.len_off = align(h.off_off + (wl->n + 1) * sizeof(uint32_t));
+    h.text_off = align(h.len_off + wl->n);
+    h.text_len = wl->textlen;
+    h.size = h.text_off + h.text_len + DICT_PAD;
+    if (m != NULL) {
+        h.flags |= DICT_F_MPH;
+        h.mph_seed = m->seed;
+        h.mph_buckets = m->nbuckets;
+        h.pilot_off = align(h.size);
+        h.slot_off = align(h.pilot_off + m->nbuckets * sizeof(uint32_t));
+        h.size = h.slot_off + wl->n * sizeof(uint32_t);
+    }
+    wl->off[wl->n] = wl->textlen;
+
+    fp = create(path, &tmp);
+    put(fp, &h, sizeof(h), 0);
+    put(fp, wl->off, (wl->n + 1) * sizeof(uint32_t), h.off_off);
+    put(fp, wl->len, wl->n, h.len_off);
+    put(fp, wl->text, wl->textlen, h.text_off);
+    put(fp, pad, sizeof(pad), h.text_off + h.text_len);
+    if (m != NULL) {
+        put(fp, m->pilot, m->nbuckets * sizeof(uint32_t), h.pilot_off);
+        put(fp, m->slot, wl->n * sizeof(uint32_t), h.slot_off);
+    }
+    commit(fp, tmp, path);
+}
+
+static void
+put_c_array(FILE *fp, const char *decl, const uint32_t *v, size_t n) {
+    size_t      i;
+
+    fprintf(fp, "%s = {", decl);
+    for (i = 0; i < n; i++)
+        fprintf(fp, "%s %u,", i % 10 == 0 ? "\n   " : "", v[i]);
+    fprintf(fp, "\n};\n");
+}
+
+/*
+ *  -c: the list as C tables, for the built-in list: a word per
+ *  4-byte slot, a bitmap of the 4-letter words, the byte shuffles
+ *  the vector kernels use and the perfect hash, all const, so they
+ *  go in .rodata and are shared by every process.  That layout
+ *  needs 2^k words of three or four letters.
+ */
+#define	C_ALIGN		"__attribute__((aligned(64)))"
+
+static void
+put_c_words(FILE *fp, const struct wordlist *wl, unsigned k) {
+    char        q[8];
+    size_t      i;
+    int         n;
+
+    fprintf(fp, "#define\tNWORDS_BITS\t%u\n\n", k);
+    fprintf(fp, "static const char words[1 << NWORDS_BITS][4] %s = {",
+        C_ALIGN);
+    for (i = 0; i < wl->n; i++) {
+        n = snprintf(q, sizeof(q), "\"%.*s\"%s", (int)wl->len[i],
+            wl->text + wl->off[i], i + 1 < wl->n ? "," : "");
+        fprintf(fp, "%s%s%*s", i % 8 == 0 ? "\n    " : "", q,
+            i % 8 != 7 && i + 1 < wl->n ? 8 - n : 0, "");
+    }
+    fprintf(fp, "\n};\n\n");
+
+    fprintf(fp, "static const uint8_t wordlen4[%zu] %s = {", wl->n / 8,
+        C_ALIGN);
+    for (i = 0; i < wl->n; i += 8) {
+        unsigned    b = 0, j;
+
+        for (j = 0; j < 8; j++)
+            b |= (wl->len[i + j] == 4) << j;
+        fprintf(fp, "%s0x%02x%s", i % 64 == 0 ? "\n    " : " ", b,
+            i + 8 < wl->n ? "," : "");
+    }
+    fprintf(fp, "\n};\n\n");
+}
+
+static void
+put_c_bytes(FILE *fp, const uint8_t v[16]) {
+    unsigned    i;
+
+    for (i = 0; i < 16; i++)
+        fprintf(fp, "%s0x%02x%s", i == 0 ? "        { " : i == 8 ?
+            "\n          " : " ", v[i], i < 15 ? "," : " },\n");
+}
+
+/*
+ *  shuftab[s][c][m] squeezes a 16-byte register of c slots, those
+ *  flagged in m holding four letters, into c words, each followed
+ *  by a hole for the separator if s.
+ */
+static void
+put_c_shuffles(FILE *fp) {
+    uint8_t     ctrl[16], term[16];
+    unsigned    s, c, m, j, k, o;
+
+    fprintf(fp, "static const struct shuf shuftab[2][4][8] %s = {\n",
+        C_ALIGN);
+    for (s = 0; s < 2; s++)
+        for (c = 1; c < 4; c++)
+            for (m = 0; m < 8; m++) {
+                memset(ctrl, 0x80, sizeof(ctrl));
+                memset(term, 0, sizeof(term));
+                for (o = 0, j = 0; j < c; j++) {
+                    for (k = 0; k < 3 + ((m >> j) & 1); k++)
+                        ctrl[o++] = j * 4 + k;
+                    if (s)
+                        term[o++] = 0xff;
+                }
+                fprintf(fp, "    [%u][%u][%u] = {\n", s, c, m);
+                put_c_bytes(fp, ctrl);
+                put_c_bytes(fp, term);
+                fprintf(fp, "        %u },\n", o);
+            }
+    fprintf(fp, "};\n\n");
+}
+
+static void
+write_c(const struct wordlist *wl, const struct mph *m, const char *src,
+    const char *path) {
+    char        decl[96], *tmp;
+    unsigned    k;
+    FILE        *fp;
+
+    for (k = 0; (1ULL << k) < wl->n; k++)
+        ;
+    if ((1ULL << k) != wl->n || k < 3 || wl->minlen < 3 ||
+        wl->maxlen > 4) {
+        fprintf(stderr, "mkdict : -c needs 2^k words (k >= 3) of three "
+            "or four letters\n");
+        exit(EINVAL);
+    }
+    fp = create(path, &tmp);
+    fprintf(fp, "/*\n"
+        " *  Generated by mkdict -c from %s; do not edit.  The\n"
+        " *  built-in list of %zu words, with the perfect hash of it\n"
+        " *  case folded (see dict.h).\n"
+        " */\n\n", src, wl->n);
+    put_c_words(fp, wl, k);
+    put_c_shuffles(fp);
+    fprintf(fp, "#define\tMPH_SEED\t0x%016llxULL\n",
+        (unsigned long long)m->seed);
+    fprintf(fp, "#define\tMPH_BUCKETS\t%u\n\n", m->nbuckets);
+    snprintf(decl, sizeof(decl),
+        "static const uint32_t mph_pilot[MPH_BUCKETS] %s", C_ALIGN);
+    put_c_array(fp, decl, m->pilot, m->nbuckets);
+    snprintf(decl, sizeof(decl), "\nstatic const %s mph_slot[%zu] %s",
+        wl->n <= 65536 ? "uint16_t" : "uint32_t", wl->n, C_ALIGN);
+    put_c_array(fp, decl, m->slot, wl->n);
+    commit(fp, tmp, path);
+}
+
+static void usage(int) __attribute__((__noreturn__));
+
+static void
+usage(int status) {
+    fprintf(stderr, "usage: mkdict [-chk] [-o dict] [wordlist]\n");
+    fprintf(stderr, "  -h : print this message\n");
+    fprintf(stderr, "  -c : write the built-in list's C tables instead\n");
+    fprintf(stderr, "  -k : keep the case of each word as given\n");
+    fprintf(stderr, "  -o dict : write the dictionary to dict "
+        "(default mkpasswd.dict)\n");
+    fprintf(stderr, "  wordlist : one word per line (default stdin)\n");
+    exit(status);
+}
+
+int
+main(int argc, char *argv[]) {
+    struct wordlist     wl;
+    const char          *out = "mkpasswd.dict";
+    FILE                *fp = stdin;
+    struct mph          mph;
+    uint32_t            flags, sbits, sreject;
+    int                 ch, keepcase = 0, ctables = 0, hashed;
+
+    while ((ch = getopt(argc, argv, "chko:")) != -1)
+        switch(ch) {
+        case 'c':
+            ctables = 1;
+            break;
+
+        case 'k':
+            keepcase = 1;
+            break;
+
+        case 'o':
+            out = optarg;
+            break;
+
+        case 'h':
+            usage(0);
+        default:
+            usage(EINVAL);
+    }
+    argc -= optind;
+    argv += optind;
+    if (argc > 1)
+        usage(EINVAL);
+    if (argc == 1 && (fp = fopen(argv[0], "r")) == NULL)
+        fail(argv[0]);
+
+    memset(&wl, 0, sizeof(wl));
+    read_words(&wl, fp, keepcase);
+    drop_duplicates(&wl);
+    if (wl.n < 2) {
+        fprintf(stderr, "mkdict : need at least two words\n");
+        exit(EINVAL);
+    }
+    flags = DICT_F_UNIQUE;
+    if (decodable(&wl, 0))
+        flags |= DICT_F_DECODABLE;
+    if (decodable(&wl, 1))
+        flags |= DICT_F_DECODABLE_NOCASE;
+    hashed = mph_build(&wl, &mph);
+    if (ctables) {
+        if (!hashed) {
+            fprintf(stderr, "mkdict : no perfect hash: words differ only "
+                "in case\n");
+            exit(EINVAL);
+        }
+        write_c(&wl, &mph, argc == 1 ? argv[0] : "stdin", out);
+        return 0;
+    }
+    write_dict(&wl, flags, hashed ? &mph : NULL, out);
+    printf("%s: %zu words, %u-%u bytes, %.2f bits per word\n", out, wl.n,
+        wl.minlen, wl.maxlen, log2((double)wl.n));
+    printf("%s: %.2f random bits drawn per word\n", out,
+        sample_width(wl.n, &sbits, &sreject));
+    if (!(flags & DICT_F_DECODABLE))
+        printf("%s: words run together ambiguously; use a separator\n",
+            out);
+    else if (!(flags & DICT_F_DECODABLE_NOCASE))
+        printf("%s: without a separator, only case marks the word "
+            "boundaries\n", out);
+    if (!hashed)
+        printf("%s: words differ only in case; --decode is unavailable\n",
+            out);
+    return 0;
+}
@@ -35,7 +35,9 @@
 /*
  *  mkpasswd:   a passphrase generator
  *
- *          To compile:    cc -O0 -o mkpasswd mkpasswd.c
+ *          To compile:    make
+ *                   or:   cc -O2 -pthread -o mkpasswd mkpasswd.c \
+ *                             serve.c libmkpasswd.c -lm
  *    
  *          mkpasswd was inspired by the babble strings produced
  *          by the original Bellcore S/Key OTP generator - however,
@@ -48,6 +50,12 @@
  *          are selected at random from a dictionary of 2048 words,
  *          yielding 2^66 possible passphrases.
  *    
+ *          -w picks another word count, at 11 bits a word: 4 for
+ *          44-bit PINs, 7 or 8 for 77 or 88 bits.
+ *
+ *          -f takes the words from a dictionary compiled by mkdict
+ *          instead, at log2(size) bits a word.
+ *
  *          To make passphrases more legible, the -s option inserts
  *          spaces, and the -d option inserts dashes.  It is up to
  *          the user whether to include these.
@@ -59,327 +67,2137 @@
  *          different design, using a 256-bit variant of Yarrow
  *          when no hardware RNG is present, with support for
  *          hardware RNGs if available.
+ *
+ *          Where the system offers it, entropy is taken from
+ *          getrandom(2) (Linux) or arc4random_buf(3) (BSD, OS X)
+ *          instead, which need no device node; RANDDEV remains
+ *          the fallback.  mkpasswd --backend reports the choice.
+ *
+ *          With --csprng, the system RNG supplies only a 256-bit
+ *          key (per thread, and again every MB MiB if asked) for a
+ *          ChaCha20 generator with fast key erasure; the output is
+ *          then as strong as the system RNG and ChaCha20 together,
+ *          and the bound above still holds.
  */
 
-#include <err.h>
+#if defined(__linux__)
+#define	_GNU_SOURCE			/* vmsplice(2), F_SETPIPE_SZ */
+#endif
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
 #include <errno.h>
 #include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <strings.h>
+#include <time.h>
 #include <unistd.h>
 
+#include "mkpasswd.h"
+#include "serve.h"
 
-#define WORDS_PER_PHRASE	6
-#ifdef __linux__
-#define	RANDDEV	"/dev/urandom"
+
+#define	ENTROPY_BUFSIZE		(16 * 1024)
+#define	ENTROPY_BUFSIZE_MIN	16
+#define	ENTROPY_BUFSIZE_MAX	(1024 * 1024)
+#define	OUTBUF_SIZE		(64 * 1024)
+#define	OUTBUF_FILE		(1024 * 1024)	/* for a regular file */
+#define	PIPE_SIZE		(1024 * 1024)	/* asked of a pipe */
+#define	BATCH			256
+#define	CHUNK			8192
+#define	MAX_THREADS		256
+#define	MAX_SHARDS		(1u << 20)	/* shard * MAX_THREADS < 2^32 */
+#define	DEDUP_MB		64		/* --dedup default */
+#define	DEDUP_MB_MAX		(1u << 16)
+#define	BLOOM_K			5		/* bits set per tuple */
+#define	PREFETCH_DEPTH		2		/* --prefetch default */
+
+/*
+ *  With -DMKPASSWD_TIMING, --stats also reports the time spent in
+ *  each stage, read once per batch or write.  The library times
+ *  its own stages under the same flag.
+ */
+#ifdef MKPASSWD_TIMING
+static inline unsigned long long
+stage_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#define	STAGE_START(t)		((t) = stage_ns())
+#define	STAGE_ADD(acc, t)	((acc) += stage_ns() - (t))
 #else
-#define	RANDDEV	"/dev/random"
+#define	STAGE_START(t)		((void)(t))
+#define	STAGE_ADD(acc, t)	((void)(t))
+#endif
+
+
+static void fail(const char *) __attribute__((__noreturn__));
+
+/*
+ *  Report a failed library or system call and exit with its errno.
+ */
+static void
+fail(const char *what) {
+    int     err = errno != 0 ? errno : EIO;
+
+    fprintf(stderr, "mkpasswd : %s: %s\n", what, strerror(err));
+    exit(err);
+}
+
+static void *
+xmalloc(size_t n) {
+    void    *p;
+
+    if ((p = malloc(n)) == NULL) {
+        fprintf(stderr, "mkpasswd : out of memory\n");
+        exit(ENOMEM);
+    }
+    return p;
+}
+
+
+/*
+ *  Buffers that hold passphrases or the entropy behind them come
+ *  from the library's locked arena, or the heap once it runs out.
+ */
+static void *
+xsecure(size_t n) {
+    void    *p;
+
+    if ((p = mkpasswd_secure_alloc(n)) == NULL) {
+        fprintf(stderr, "mkpasswd : out of memory\n");
+        exit(ENOMEM);
+    }
+    return p;
+}
+
+
+/*
+ *  Output is assembled in a large page-aligned buffer and handed to
+ *  write(2) whenever it cannot take another batch, so a bulk run
+ *  costs one syscall per buffer and no stdio formatting.  To a
+ *  pipe on Linux the buffer is instead passed by reference with
+ *  vmsplice(2) and the pages move without a copy.  The pipe then
+ *  holds on to them until they are read, so the buffer has two
+ *  halves, used in turn, each a batch larger than the pipe: as the
+ *  buffer is flushed only when it cannot take another batch, a
+ *  half always sends more than the pipe holds, and once it is all
+ *  in the pipe nothing is left there of the other half, which can
+ *  be filled again.  A flushed buffer is wiped before it is reused,
+ *  in one pass rather than phrase by phrase; the half that comes
+ *  back after a vmsplice held the phrases the reader has just
+ *  taken.  With --fsync the data is flushed to disk when done, and
+ *  every sync_every bytes if that is not 0.
+ */
+struct outbuf {
+    int                 fd;
+    char                *buf;
+    size_t              size, len;
+    char                *spare;         /* vmsplice: the other half */
+    size_t              spare_len;      /* what it sent last */
+    int                 splice;
+    int                 sync;
+    unsigned long long  sync_every, since_sync;
+    unsigned long long  writes, bytes;
+    unsigned long long  format_ns, write_ns;
+    unsigned long long  dups;           /* --dedup: phrases dropped */
+};
+
+static void
+out_sync(struct outbuf *o, size_t n, int done) {
+    if (!o->sync)
+        return;
+    o->since_sync += n;
+    if (!done && (o->sync_every == 0 || o->since_sync < o->sync_every))
+        return;
+    /* a pipe or terminal has nothing to sync */
+    if (fsync(o->fd) != 0 && errno != EINVAL && errno != ENOTSUP)
+        fail("fsync");
+    o->since_sync = 0;
+}
+
+/*
+ *  CPU time of the process at its first write, loader, libc and
+ *  set-up included, for --stats.
+ */
+static unsigned long long   first_byte_ns;
+
+static void
+out_send(struct outbuf *o) {
+    unsigned long long  t = 0;
+    struct timespec     ts;
+    ssize_t         r;
+    size_t          off = 0;
+
+    if (first_byte_ns == 0 && o->len != 0 &&
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0)
+        first_byte_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+    STAGE_START(t);
+    while (off < o->len) {
+#if defined(__linux__)
+        if (o->spare != NULL) {
+            struct iovec    iov = { o->buf + off, o->len - off };
+
+            r = vmsplice(o->fd, &iov, 1, 0);
+        } else
 #endif
+            r = write(o->fd, o->buf + off, o->len - off);
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r < 0)
+            fail("write error");
+        off += r;
+        o->writes++;
+    }
+    STAGE_ADD(o->write_ns, t);
+    o->bytes += o->len;
+    out_sync(o, o->len, 0);
+}
+
+/*
+ *  Send a full buffer, or a write(2) one at any point.
+ */
+static void
+out_flush(struct outbuf *o) {
+    char            *t;
+
+    out_send(o);
+    if (o->spare == NULL)
+        mkpasswd_secure_wipe(o->buf, o->len);
+    else if (o->len != 0) {
+        t = o->buf;
+        o->buf = o->spare;
+        o->spare = t;
+        mkpasswd_secure_wipe(o->buf, o->spare_len);
+        o->spare_len = o->len;
+    }
+    o->len = 0;
+}
+
+/*
+ *  Set o up to write to fd, where nothing larger than room is put
+ *  in the buffer at once, and return the memory out_alloc() will
+ *  take for it.  If whole, room holds the whole run, which is then
+ *  one write(2) from a buffer just that size: a short run from a
+ *  hook or script maps, locks and wipes a page or two, and asks
+ *  nothing of the pipe.
+ */
+static size_t
+out_plan(struct outbuf *o, int fd, size_t room, int whole) {
+    struct stat     sb;
+    size_t          size = OUTBUF_SIZE;
+
+    o->fd = fd;
+    o->splice = 0;
+    o->len = 0;
+    o->since_sync = 0;
+    o->writes = o->bytes = 0;
+    o->format_ns = o->write_ns = 0;
+    o->dups = 0;
+    if (whole) {
+        o->size = room > 0 ? room : 1;
+        return o->size;
+    }
+    if (fstat(fd, &sb) != 0)
+        fail("output");
+    if (S_ISREG(sb.st_mode))
+        size = OUTBUF_FILE;
+#if defined(__linux__)
+    if (S_ISFIFO(sb.st_mode)) {
+        size_t  pg;
+        int     pipesz;
+
+        /* take what the pipe will give; root may get more */
+        fcntl(fd, F_SETPIPE_SZ, PIPE_SIZE);
+        if ((pipesz = fcntl(fd, F_GETPIPE_SZ)) > 0) {
+            /* whole pages, so that the halves share none */
+            pg = sysconf(_SC_PAGESIZE);
+            size = (pipesz + room + pg - 1) / pg * pg;
+            o->splice = 1;
+        }
+    }
+#endif
+    if (size < room)
+        size = room;
+    o->size = size;
+    return o->splice ? 2 * size : size;
+}
+
+/*
+ *  What xsecure(n) takes from the arena.
+ */
+static size_t
+secure_size(size_t n) {
+    size_t  pg = sysconf(_SC_PAGESIZE);
+
+    return (n + pg - 1) / pg * pg;
+}
+
+/*
+ *  What mkpasswd_set_prefetch() takes from the arena for depth
+ *  blocks of bufsize bytes, its own context included.
+ */
+static size_t
+prefetch_size(unsigned depth, size_t bufsize) {
+    return depth == 0 ? 0 :
+        depth * secure_size(bufsize) + secure_size(sizeof(mkpasswd_ctx) +
+        MKPASSWD_PREFETCH_MAX * (sizeof(void *) + sizeof(int)) + 256);
+}
+
+/*
+ *  Map an arena of size bytes for xsecure(); with --mlock it must
+ *  be locked into RAM, and otherwise that is only tried.
+ */
+static void
+secure_setup(size_t size, int must) {
+    int     r;
+
+    if ((r = mkpasswd_secure_init(size)) < 0 || (r > 0 && must))
+        fail(r < 0 ? "secure memory" : "mlock");
+}
+
+static void
+out_alloc(struct outbuf *o) {
+    if (o->splice) {
+        o->spare = xsecure(2 * o->size);
+        o->buf = o->spare + o->size;
+    } else {
+        o->spare = NULL;
+        o->buf = xsecure(o->size);
+    }
+    o->spare_len = 0;
+}
+
+/*
+ *  -o path, or standard output.  Passphrases are for one reader.
+ */
+static int
+out_file(const char *path) {
+    int     fd;
+
+    if (path == NULL)
+        return STDOUT_FILENO;
+    if ((fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+        0600)) < 0)
+        fail(path);
+    return fd;
+}
+
+/*
+ *  Flush o, sync it if asked, close any -o file and free the
+ *  buffer.  The halves of a vmsplice buffer may still be in the
+ *  pipe, so they are neither wiped nor freed but go with the
+ *  process.
+ */
+static void
+out_close(struct outbuf *o) {
+    /* too short, perhaps, to push the other half out of the pipe */
+    if (o->spare != NULL)
+        out_send(o);
+    else
+        out_flush(o);
+    out_sync(o, 0, 1);
+    if (o->fd != STDOUT_FILENO && close(o->fd) != 0)
+        fail("write error");
+    if (o->spare == NULL)
+        mkpasswd_secure_free(o->buf, o->size);
+}
+
+
+/*
+ *  Output formats.  raw is a phrase per line, nul the same ended by
+ *  NUL bytes for xargs -0, and jsonl a JSON object per line with
+ *  the phrase, its entropy and, if asked, the word indices.  Every
+ *  format is written straight into the output buffer: for jsonl
+ *  the library puts a batch of phrases at the end of the space
+ *  reserved for it, and each record is then laid down from the
+ *  front, moving its phrase forward, since a record never ends past
+ *  the start of the phrases still to be read.
+ */
+#define	FMT_RAW		0
+#define	FMT_NUL		1
+#define	FMT_JSONL	2
+#define	FMT_TSV		3
+
+#define	JSON_HEAD	"{\"phrase\":\""
+#define	JSON_INDICES	",\"indices\":["
+#define	JSON_MAX	64	/* a record, but for phrase and indices */
+#define	DEC_MAX		(1u << 16)	/* largest list with an index table */
+#define	TSV_MAX		24	/* a record, but for tuple and phrase */
+
+struct format {
+    int         kind;
+    int         indices;        /* jsonl: list the word indices */
+    int         plain;          /* no byte of a phrase needs escaping */
+    char        bits[32];       /* jsonl: "\",\"bits\":66.00" */
+    size_t      bitslen;
+    char        (*dec)[8];      /* "397," for index 397, length in [7] */
+    const mkpasswd_policy   *pol;   /* --max-len and the like, or NULL */
+    unsigned    kbits;          /* bits of a tuple per word */
+    struct bloom            *dedup; /* --dedup, or NULL */
+};
+
+/*
+ *  Decimal v (below 10^8, as every index is), two digits at a time.
+ */
+static inline char *
+put_uint(char *p, uint32_t v) {
+    static const char   pairs[] =
+        "00010203040506070809101112131415161718192021222324"
+        "25262728293031323334353637383940414243444546474849"
+        "50515253545556575859606162636465666768697071727374"
+        "75767778798081828384858687888990919293949596979899";
+    unsigned    n = v < 10 ? 1 : v < 100 ? 2 : v < 1000 ? 3 : v < 10000 ? 4 :
+                    v < 100000 ? 5 : v < 1000000 ? 6 : v < 10000000 ? 7 : 8;
+    char        *e = p + n;
+
+    while (v >= 100) {
+        e -= 2;
+        memcpy(e, pairs + 2 * (v % 100), 2);
+        v /= 100;
+    }
+    if (v >= 10)
+        memcpy(e - 2, pairs + 2 * v, 2);
+    else
+        e[-1] = '0' + v;
+    return p + n;
+}
+
+static inline char *
+put_ull(char *p, unsigned long long v) {
+    char        t[20];
+    unsigned    n = 0;
+
+    do
+        t[n++] = '0' + v % 10;
+    while ((v /= 10) != 0);
+    while (n > 0)
+        *p++ = t[--n];
+    return p;
+}
+
+/*
+ *  The bits a phrase stands for in hex: the word indices in turn,
+ *  k bits each, least significant bit first; (nw * k + 7) / 8 * 2
+ *  digits.
+ */
+static char *
+put_tuple(char *p, const uint32_t *idx, unsigned nw, unsigned k) {
+    static const char   hex[] = "0123456789abcdef";
+    uint64_t    acc;
+    unsigned    nbits, j;
+
+    for (acc = 0, nbits = 0, j = 0; j < nw; j++) {
+        acc |= (uint64_t)idx[j] << nbits;
+        for (nbits += k; nbits >= 8; nbits -= 8, acc >>= 8) {
+            *p++ = hex[acc >> 4 & 0xf];
+            *p++ = hex[acc & 0xf];
+        }
+    }
+    if (nbits > 0) {
+        *p++ = hex[acc >> 4 & 0xf];
+        *p++ = hex[acc & 0xf];
+    }
+    return p;
+}
+
+static unsigned
+tuple_bits(const mkpasswd_dict *dict) {
+    size_t      n = mkpasswd_dict_words(dict);
+    unsigned    k;
+
+    for (k = 0; (1ULL << k) < n; k++)
+        ;
+    return k;
+}
+
+static void
+format_init(struct format *f, const mkpasswd_dict *dict, unsigned nw,
+    char sep) {
+    size_t  i;
+    int     n;
+
+    n = snprintf(f->bits, sizeof(f->bits), "\",\"bits\":%.2f",
+        f->pol != NULL ? mkpasswd_policy_entropy_bits(f->pol) :
+        mkpasswd_dict_entropy_bits(dict, nw));
+    f->bitslen = n;
+    f->kbits = tuple_bits(dict);
+    /* the built-in words are letters only; a file could hold anything */
+    f->plain = dict == NULL && (sep == 0 || sep == '-' || sep == ' ');
+    f->dec = NULL;
+    if (f->indices && (i = mkpasswd_dict_words(dict)) <= DEC_MAX) {
+        f->dec = xmalloc(i * sizeof(*f->dec));
+        memset(f->dec, 0, i * sizeof(*f->dec));
+        while (i-- > 0) {
+            f->dec[i][7] = put_uint(f->dec[i], i) - f->dec[i] + 1;
+            f->dec[i][f->dec[i][7] - 1] = ',';
+        }
+    }
+}
+
+/*
+ *  Bytes the library wants for count phrases.
+ */
+static size_t
+format_raw(const struct format *f, const mkpasswd_dict *dict,
+    size_t count, unsigned nw) {
+    if (f->pol != NULL)
+        return mkpasswd_policy_batch_size(f->pol, count);
+    return mkpasswd_dict_batch_size(dict, count, nw);
+}
+
+/*
+ *  Room to reserve in an output buffer for count phrases.  An
+ *  escaped byte takes at most six; what a policy inserts never
+ *  needs escaping.
+ */
+static size_t
+format_room(const struct format *f, const mkpasswd_dict *dict,
+    size_t count, unsigned nw) {
+    size_t  room = format_raw(f, dict, count, nw);
+
+    if (f->kind == FMT_JSONL)
+        room += count * (JSON_MAX + (f->indices ? nw * 9 : 0) +
+            (f->plain ? 0 : 5 * (mkpasswd_dict_batch_size(dict, 1, nw) -
+            mkpasswd_dict_batch_size(dict, 0, nw))));
+    else if (f->kind == FMT_TSV)
+        room += count * (TSV_MAX + (nw * f->kbits + 7) / 8 * 2);
+    return room;
+}
+
+static char *
+put_escaped(char *p, const char *s, size_t len) {
+    static const char   hex[] = "0123456789abcdef";
+    unsigned char       c;
+    size_t              i;
+
+    for (i = 0; i < len; i++) {
+        c = s[i];
+        if (c == '"' || c == '\\') {
+            *p++ = '\\';
+            *p++ = c;
+        } else if (c < 0x20) {
+            memcpy(p, "\\u00", 4);
+            p[4] = hex[c >> 4];
+            p[5] = hex[c & 15];
+            p += 6;
+        } else
+            *p++ = c;
+    }
+    return p;
+}
+
+/*
+ *  Turn the len bytes of count phrases at src into records at dst,
+ *  which lies before them; returns the length of the records.  A
+ *  tabled index is copied as 8 bytes, which may run up to 7 past
+ *  the record; JSON_MAX allows more than that beyond any record.
+ */
+static size_t
+format_jsonl(const struct format *f, char *dst, const char *src, size_t len,
+    const uint32_t *idx, size_t count, unsigned nw) {
+    const char  *end = src + len, *nl;
+    char        *p = dst;
+    size_t      i;
+    unsigned    w;
+
+    for (i = 0; i < count && src < end; i++, src = nl + 1) {
+        nl = memchr(src, '\n', end - src);
+        memcpy(p, JSON_HEAD, sizeof(JSON_HEAD) - 1);
+        p += sizeof(JSON_HEAD) - 1;
+        if (f->plain) {
+            memmove(p, src, nl - src);
+            p += nl - src;
+        } else
+            p = put_escaped(p, src, nl - src);
+        memcpy(p, f->bits, f->bitslen);
+        p += f->bitslen;
+        if (f->indices) {
+            memcpy(p, JSON_INDICES, sizeof(JSON_INDICES) - 1);
+            p += sizeof(JSON_INDICES) - 1;
+            if (f->dec != NULL)
+                for (w = 0; w < nw; w++) {
+                    memcpy(p, f->dec[idx[i * nw + w]], 8);
+                    p += f->dec[idx[i * nw + w]][7];
+                }
+            else
+                for (w = 0; w < nw; w++) {
+                    p = put_uint(p, idx[i * nw + w]);
+                    *p++ = ',';
+                }
+            p[-1] = ']';
+        }
+        *p++ = '}';
+        *p++ = '\n';
+    }
+    return p - dst;
+}
+
+
+/*
+ *  The same for --format=tsv: the phrase's number in the whole run
+ *  (seq for the first), its tuple as --decode prints it, and the
+ *  phrase.  A shard's numbers only rise, so shard files merge with
+ *  "sort -m -n", and the same tuple twice sorts together on the
+ *  second field.
+ */
+static size_t
+format_tsv(const struct format *f, char *dst, const char *src, size_t len,
+    const uint32_t *idx, size_t count, unsigned nw, unsigned long long seq) {
+    const char  *end = src + len, *nl;
+    char        *p = dst;
+    size_t      i;
+
+    for (i = 0; i < count && src < end; i++, src = nl + 1) {
+        nl = memchr(src, '\n', end - src);
+        p = put_ull(p, seq + i);
+        *p++ = '\t';
+        p = put_tuple(p, idx + i * nw, nw, f->kbits);
+        *p++ = '\t';
+        memmove(p, src, nl + 1 - src);
+        p += nl + 1 - src;
+    }
+    return p - dst;
+}
+
+
+/*
+ *  --dedup: a Bloom filter over the index tuples of the run, in
+ *  words that every thread sets with an atomic or, so no lock is
+ *  taken.  Under a policy it is over the phrases themselves, as the
+ *  digit or symbol put in makes one tuple many phrases.  A key sets
+ *  BLOOM_K bits picked by double hashing; if they were all set
+ *  already it may have been made before, and its phrase is dropped
+ *  for another.  At 16 bits a phrase (the default
+ *  64 MiB for 32 million) about 1 in 700 goes without cause, which
+ *  costs a draw and no entropy.  The filter says which phrases were
+ *  made, so it is kept out of core dumps like the rest.
+ */
+struct bloom {
+    _Atomic uint64_t    *w;
+    size_t              size;
+    uint64_t            mask;           /* bits - 1 */
+};
+
+static struct bloom *
+bloom_create(unsigned long long mb) {
+    struct bloom    *b = xmalloc(sizeof(*b));
+
+    /* a power of two, so that a bit is picked with a mask */
+    for (b->size = 1; b->size <= (mb << 20) / 2; b->size <<= 1)
+        ;
+    b->w = mmap(NULL, b->size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (b->w == MAP_FAILED)
+        fail("--dedup");
+#if defined(MADV_DONTDUMP)
+    madvise(b->w, b->size, MADV_DONTDUMP);
+#elif defined(MADV_NOCORE)
+    madvise(b->w, b->size, MADV_NOCORE);
+#endif
+    b->mask = b->size * 8 - 1;
+    return b;
+}
+
+static void
+bloom_destroy(struct bloom *b) {
+    if (b == NULL)
+        return;
+    munmap(b->w, b->size);
+    free(b);
+}
+
+/*
+ *  Set the bits of a key hashed to h; returns 1 if they all were.
+ */
+static int
+bloom_set(struct bloom *b, uint64_t h) {
+    uint64_t    d, bit, old;
+    unsigned    j;
+    int         seen = 1;
+
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 29;
+    d = (h >> 32 | h << 32) | 1;
+    for (j = 0; j < BLOOM_K; j++, h += d) {
+        bit = h & b->mask;
+        old = atomic_fetch_or_explicit(&b->w[bit >> 6], 1ULL << (bit & 63),
+            memory_order_relaxed);
+        seen &= (old >> (bit & 63)) & 1;
+    }
+    return seen;
+}
+
+/*
+ *  Add the tuple; returns 1 if it may have been added before.
+ */
+static int
+bloom_add(struct bloom *b, const uint32_t *idx, unsigned nw) {
+    uint64_t    h = 0x9e3779b97f4a7c15ULL * nw;
+    unsigned    j;
+
+    for (j = 0; j < nw; j++) {
+        h = (h ^ idx[j]) * 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 31;
+    }
+    return bloom_set(b, h);
+}
+
+/*
+ *  The same for the len bytes of a phrase, eight at a time.
+ */
+static int
+bloom_add_text(struct bloom *b, const char *p, size_t len) {
+    uint64_t    h = 0x9e3779b97f4a7c15ULL * (len + 1), v;
+    size_t      i;
+
+    for (i = 0; i < len; i += 8) {
+        v = 0;
+        memcpy(&v, p + i, len - i < 8 ? len - i : 8);
+        h = (h ^ v) * 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 31;
+    }
+    return bloom_set(b, h);
+}
+
+/*
+ *  Drop from the *len bytes of nb phrases at p, whose indices are
+ *  at idx, those the filter may have seen, closing up the text and
+ *  the indices and wiping what is left over; by text if bytext.
+ *  Returns how many phrases remain.
+ */
+static size_t
+dedup(struct bloom *b, char *p, ssize_t *len, uint32_t *idx, size_t nb,
+    unsigned nw, int bytext, unsigned long long *dups) {
+    char        *src = p, *dst = p, *end = p + *len, *nl;
+    size_t      i, kept = 0;
+
+    for (i = 0; i < nb; i++, src = nl + 1) {
+        nl = memchr(src, '\n', end - src);
+        if (bytext ? bloom_add_text(b, src, nl - src) :
+            bloom_add(b, idx + i * nw, nw)) {
+            (*dups)++;
+            continue;
+        }
+        memmove(dst, src, nl + 1 - src);
+        memmove(idx + kept * nw, idx + i * nw, nw * sizeof(*idx));
+        dst += nl + 1 - src;
+        kept++;
+    }
+    mkpasswd_secure_wipe(dst, end - dst);
+    *len = dst - p;
+    return kept;
+}
+
+
+/*
+ *  Replace every newline in p[0..len) with NUL, eight bytes at a
+ *  time: a byte of t is zero where p had a newline, and the usual
+ *  carry-free test sets the top bit of each byte of t that is not.
+ */
+static void
+nul_ends(char *p, size_t len) {
+    const uint64_t  ones = 0x0101010101010101ULL;
+    uint64_t        v, t, nz;
+    size_t          i;
+
+    for (i = 0; i + 8 <= len; i += 8) {
+        memcpy(&v, p + i, 8);
+        t = v ^ ('\n' * ones);
+        nz = (((t & (0x7f * ones)) + 0x7f * ones) | t) & (0x80 * ones);
+        v &= (nz >> 7) * 0xff;
+        memcpy(p + i, &v, 8);
+    }
+    for (; i < len; i++)
+        if (p[i] == '\n')
+            p[i] = 0;
+}
+
+
+/*
+ *  Generate count passphrases of nw words from dict into o, BATCH
+ *  at a time, in format f; seq is the number of the first in the
+ *  whole run.
+ */
+static void
+generate(mkpasswd_ctx *ctx, const mkpasswd_dict *dict, struct outbuf *o,
+    const struct format *f, unsigned long long count, unsigned nw, char sep,
+    unsigned long long seq) {
+    uint32_t    idx[BATCH * MKPASSWD_MAX_WORDS];
+    unsigned long long  t = 0;
+    size_t      nb, room, raw;
+    ssize_t     len;
+    char        *at;
+    int         want = f->indices || f->kind == FMT_TSV || f->dedup != NULL;
+
+    while (count > 0) {
+        nb = count < BATCH ? count : BATCH;
+        room = format_room(f, dict, nb, nw);
+        if (o->size - o->len < room)
+            out_flush(o);
+        raw = format_raw(f, dict, nb, nw);
+        at = o->buf + o->len + (f->kind == FMT_JSONL ||
+            f->kind == FMT_TSV ? room - raw : 0);
+        if (f->pol != NULL)
+            len = mkpasswd_generate_policy(ctx, f->pol, at, raw, nb,
+                want ? idx : NULL);
+        else
+            len = mkpasswd_generate_batch_idx(ctx, at, raw, nb, nw, sep,
+                want ? idx : NULL);
+        if (len < 0)
+            fail("unable to read entropy");
+        STAGE_START(t);
+        if (f->dedup != NULL)
+            nb = dedup(f->dedup, at, &len, idx, nb, nw, f->pol != NULL,
+                &o->dups);
+        if (f->kind == FMT_JSONL)
+            len = format_jsonl(f, o->buf + o->len, at, len, idx, nb, nw);
+        else if (f->kind == FMT_TSV)
+            len = format_tsv(f, o->buf + o->len, at, len, idx, nb, nw, seq);
+        else if (f->kind == FMT_NUL)
+            nul_ends(at, len);
+        STAGE_ADD(o->format_ns, t);
+        o->len += len;
+        count -= nb;
+        seq += nb;
+    }
+}
+
+
+/*
+ *  Threaded generation.  The run is cut into chunks of CHUNK
+ *  phrases; worker t makes chunks t, t + nthr, ... into its own
+ *  pair of buffers from its own context, and the main thread
+ *  writes the chunks out in order.  With --csprng each worker seeds
+ *  its own DRBG once.  The only shared state is one flag per
+ *  buffer, passed back and forth with acquire/release atomics, so
+ *  neither side takes a lock.
+ *
+ *  With --shard K/N the run's chunks are dealt out to N hosts in
+ *  turn, and this one makes chunks K - 1, K - 1 + N, ... of them,
+ *  numbering its phrases by their place in the whole run.
+ */
+struct worker {
+    pthread_t           tid;
+    mkpasswd_ctx        ctx;
+    const mkpasswd_dict *dict;
+    const struct format *fmt;
+    unsigned char       *ebuf;
+    struct outbuf       ob[2];
+    atomic_int          full[2];
+    const unsigned char *seed;          /* --seed, or NULL */
+    unsigned            id, nthr, nwords, shard, nshards;
+    unsigned long long  count;
+    char                sep;
+};
+
+static inline unsigned long long
+chunk_len(unsigned long long count, unsigned long long c) {
+    return count - c * CHUNK < CHUNK ? count - c * CHUNK : CHUNK;
+}
+
+/* how many of the count / CHUNK chunks shard makes */
+static inline unsigned long long
+shard_chunks(unsigned long long count, unsigned shard, unsigned nshards) {
+    unsigned long long  nchunks = (count + CHUNK - 1) / CHUNK;
+
+    return nchunks > shard ? (nchunks - shard - 1) / nshards + 1 : 0;
+}
+
+/* and how many phrases */
+static unsigned long long
+shard_count(unsigned long long count, unsigned shard, unsigned nshards) {
+    unsigned long long  n = shard_chunks(count, shard, nshards), last;
 
+    if (n == 0)
+        return 0;
+    last = (n - 1) * nshards + shard;
+    return (n - 1) * CHUNK + chunk_len(count, last);
+}
+
+static void *
+worker_main(void *arg) {
+    struct worker       *w = arg;
+    unsigned long long  c, g;
+    unsigned long long  nchunks = shard_chunks(w->count, w->shard, w->nshards);
+    unsigned            slot = 0;
+
+    for (c = w->id; c < nchunks; c += w->nthr, slot ^= 1) {
+        while (atomic_load_explicit(&w->full[slot], memory_order_acquire))
+            sched_yield();
+        g = c * w->nshards + w->shard;
+        if (w->seed != NULL)
+            mkpasswd_set_seed(&w->ctx, w->seed, g);
+        generate(&w->ctx, w->dict, &w->ob[slot], w->fmt,
+            chunk_len(w->count, g), w->nwords, w->sep, g * CHUNK);
+        atomic_store_explicit(&w->full[slot], 1, memory_order_release);
+    }
+    return NULL;
+}
+
+/*
+ *  Run shard's chunks of count phrases on nthr workers set up like
+ *  ctx, writing through o in format f.  Worker counters are added
+ *  into st.  With a seed, chunk c is made from stream c of it, and
+ *  without, worker t of shard s seeds its DRBG on stream
+ *  s * MAX_THREADS + t, so no two threads anywhere share a key.
+ */
+static void
+generate_threaded(mkpasswd_ctx *ctx, const mkpasswd_dict *dict,
+    struct outbuf *o, const struct format *f,
+    struct mkpasswd_stats *st, int flags, unsigned long long reseed,
+    size_t bufsize, unsigned long long count, unsigned nw, char sep,
+    unsigned nthr, const unsigned char *seed, unsigned shard,
+    unsigned nshards, unsigned prefetch) {
+    struct mkpasswd_stats   ws_st;
+    struct worker       *ws, *w;
+    unsigned long long  c, nchunks = shard_chunks(count, shard, nshards);
+    unsigned            t, s, slot;
+    size_t              n;
+
+    if (nchunks == 0)
+        return;
+    if (nthr > nchunks)
+        nthr = nchunks;
+    if ((ws = calloc(nthr, sizeof(*ws))) == NULL) {
+        fprintf(stderr, "mkpasswd : out of memory\n");
+        exit(ENOMEM);
+    }
+    out_flush(o);
+    for (t = 0; t < nthr; t++) {
+        w = &ws[t];
+        w->ebuf = xsecure(bufsize);
+        if (mkpasswd_init(&w->ctx, flags, w->ebuf, bufsize) != 0 ||
+            (dict == NULL &&
+            mkpasswd_set_kernel(&w->ctx, mkpasswd_current_kernel(ctx)) != 0) ||
+            mkpasswd_set_sampler(&w->ctx, mkpasswd_current_sampler(ctx)) != 0)
+            fail("unable to set up generator");
+        mkpasswd_set_dict(&w->ctx, dict);
+        mkpasswd_set_reseed(&w->ctx, reseed);
+        mkpasswd_set_stream(&w->ctx,
+            (unsigned long long)shard * MAX_THREADS + t);
+        if (mkpasswd_set_prefetch(&w->ctx, prefetch) != 0)
+            fail("unable to start prefetch");
+        for (s = 0; s < 2; s++) {
+            w->ob[s].fd = o->fd;
+            w->ob[s].size = format_room(f, dict, CHUNK, nw);
+            w->ob[s].buf = xsecure(w->ob[s].size);
+            w->ob[s].spare = NULL;
+            atomic_init(&w->full[s], 0);
+        }
+        w->dict = dict;
+        w->fmt = f;
+        w->seed = seed;
+        w->id = t;
+        w->nthr = nthr;
+        w->shard = shard;
+        w->nshards = nshards;
+        w->count = count;
+        w->nwords = nw;
+        w->sep = sep;
+        if ((errno = pthread_create(&w->tid, NULL, worker_main, w)) != 0)
+            fail("unable to start thread");
+    }
+
+    for (c = 0; c < nchunks; c++) {
+        w = &ws[c % nthr];
+        slot = (c / nthr) & 1;
+        while (!atomic_load_explicit(&w->full[slot], memory_order_acquire))
+            sched_yield();
+        n = w->ob[slot].len;
+        out_flush(&w->ob[slot]);
+        atomic_store_explicit(&w->full[slot], 0, memory_order_release);
+        out_sync(o, n, 0);
+    }
+
+    for (t = 0; t < nthr; t++) {
+        w = &ws[t];
+        pthread_join(w->tid, NULL);
+        mkpasswd_get_stats(&w->ctx, &ws_st);
+        st->refills += ws_st.refills;
+        st->entropy_bytes += ws_st.entropy_bytes;
+        st->rng_syscalls += ws_st.rng_syscalls;
+        st->rng_bytes += ws_st.rng_bytes;
+        st->seeds += ws_st.seeds;
+        st->rejects += ws_st.rejects;
+        st->prefetch_stalls += ws_st.prefetch_stalls;
+        st->entropy_ns += ws_st.entropy_ns;
+        st->index_ns += ws_st.index_ns;
+        st->assemble_ns += ws_st.assemble_ns;
+        mkpasswd_destroy(&w->ctx);
+        mkpasswd_secure_free(w->ebuf, bufsize);
+        for (s = 0; s < 2; s++) {
+            o->dups += w->ob[s].dups;
+            o->writes += w->ob[s].writes;
+            o->bytes += w->ob[s].bytes;
+            o->format_ns += w->ob[s].format_ns;
+            o->write_ns += w->ob[s].write_ns;
+            mkpasswd_secure_free(w->ob[s].buf, w->ob[s].size);
+        }
+    }
+    free(ws);
+}
+
+
+/*
+ *  --seed or --shard on one thread: the same chunks and streams as
+ *  generate_threaded(), so the output is the same for any -j.
+ */
+static void
+generate_chunks(mkpasswd_ctx *ctx, const mkpasswd_dict *dict,
+    struct outbuf *o, const struct format *f, unsigned long long count,
+    unsigned nw, char sep, const unsigned char *seed, unsigned shard,
+    unsigned nshards) {
+    unsigned long long  c, g, nchunks = shard_chunks(count, shard, nshards);
+
+    for (c = 0; c < nchunks; c++) {
+        g = c * nshards + shard;
+        if (seed != NULL)
+            mkpasswd_set_seed(ctx, seed, g);
+        generate(ctx, dict, o, f, chunk_len(count, g), nw, sep, g * CHUNK);
+    }
+}
+
+/*
+ *  --decode: read passphrases of nw words, one per line, and print
+ *  the bits each one stands for in hex: the word indices in turn,
+ *  k bits each for a list of up to 2^k words, least significant
+ *  bit first.  For the built-in list that is the 66 bits drawn to
+ *  make the phrase.  Returns 0, or EINVAL if any line was bad.
+ */
+static int
+decode(const mkpasswd_dict *dict, struct outbuf *o, unsigned nw) {
+    uint32_t        idx[MKPASSWD_MAX_WORDS];
+    char            *line = NULL, *p;
+    size_t          cap = 0;
+    ssize_t         len, got;
+    unsigned long   lineno = 0;
+    unsigned        k = tuple_bits(dict);
+    int             status = 0;
 
-static char words[2048][5] = {
-    "Abe",  "Abed", "Abel", "Abet", "Able", "Abut", "Ace",  "Ache",
-    "Acid", "Acme", "Acre", "Act",  "Acta", "Acts", "Ada",  "Adam",
-    "Add",  "Adds", "Aden", "Afar", "Afro", "Age",  "Agee", "Ago",
-    "Ahem", "Ahoy", "Aid",  "Aida", "Aide", "Aids", "Aim",  "Air",
-    "Airy", "Ajar", "Akin", "Alan", "Alec", "Alga", "Alia", "All",
-    "Ally", "Alma", "Aloe", "Alp",  "Also", "Alto", "Alum", "Alva",
-    "Amen", "Ames", "Amid", "Ammo", "Amok", "Amos", "Amra", "Amy",
-    "Ana",  "And",  "Andy", "Anew", "Ann",  "Anna", "Anne", "Ant",
-    "Ante", "Anti", "Any",  "Ape",  "Aps",  "Apt",  "Aqua", "Arab",
-    "Arc",  "Arch", "Are",  "Area", "Argo", "Arid", "Ark",  "Arm",
-    "Army", "Art",  "Arts", "Arty", "Ash",  "Asia", "Ask",  "Asks",
-    "Ate",  "Atom", "Aug",  "Auk",  "Aunt", "Aura", "Auto", "Ave",
-    "Aver", "Avid", "Avis", "Avon", "Avow", "Away", "Awe",  "Awk",
-    "Awl",  "Awn",  "Awry", "Aye",  "Babe", "Baby", "Bach", "Back",
-    "Bad",  "Bade", "Bag",  "Bah",  "Bail", "Bait", "Bake", "Bald",
-    "Bale", "Bali", "Balk", "Ball", "Balm", "Bam",  "Ban",  "Band",
-    "Bane", "Bang", "Bank", "Bar",  "Barb", "Bard", "Bare", "Bark",
-    "Barn", "Barr", "Base", "Bash", "Bask", "Bass", "Bat",  "Bate",
-    "Bath", "Bawd", "Bawl", "Bay",  "Bead", "Beak", "Beam", "Bean",
-    "Bear", "Beat", "Beau", "Beck", "Bed",  "Bee",  "Beef", "Been",
-    "Beer", "Beet", "Beg",  "Bela", "Bell", "Belt", "Ben",  "Bend",
-    "Bent", "Berg", "Bern", "Bert", "Bess", "Best", "Bet",  "Beta",
-    "Beth", "Bey",  "Bhoy", "Bias", "Bib",  "Bid",  "Bide", "Bien",
-    "Big",  "Bile", "Bilk", "Bill", "Bin",  "Bind", "Bing", "Bird",
-    "Bit",  "Bite", "Bits", "Blab", "Blat", "Bled", "Blew", "Blob",
-    "Bloc", "Blot", "Blow", "Blue", "Blum", "Blur", "Boar", "Boat",
-    "Bob",  "Boca", "Bock", "Bode", "Body", "Bog",  "Bogy", "Bohr",
-    "Boil", "Bold", "Bolo", "Bolt", "Bomb", "Bon",  "Bona", "Bond",
-    "Bone", "Bong", "Bonn", "Bony", "Boo",  "Book", "Boom", "Boon",
-    "Boot", "Bop",  "Bore", "Borg", "Born", "Bose", "Boss", "Both",
-    "Bout", "Bow",  "Bowl", "Box",  "Boy",  "Boyd", "Brad", "Brae",
-    "Brag", "Bran", "Bray", "Bred", "Brew", "Brig", "Brim", "Brow",
-    "Bub",  "Buck", "Bud",  "Budd", "Buff", "Bug",  "Bulb", "Bulk",
-    "Bull", "Bum",  "Bun",  "Bunk", "Bunt", "Buoy", "Burg", "Burl",
-    "Burn", "Burr", "Burt", "Bury", "Bus",  "Bush", "Buss", "Bust",
-    "Busy", "But",  "Buy",  "Bye",  "Byte", "Cab",  "Cady", "Cafe",
-    "Cage", "Cain", "Cake", "Cal",  "Calf", "Call", "Calm", "Cam",
-    "Came", "Can",  "Cane", "Cant", "Cap",  "Car",  "Card", "Care",
-    "Carl", "Carr", "Cart", "Case", "Cash", "Cask", "Cast", "Cat",
-    "Cave", "Caw",  "Ceil", "Cell", "Cent", "Cern", "Chad", "Char",
-    "Chat", "Chaw", "Chef", "Chen", "Chew", "Chic", "Chin", "Chou",
-    "Chow", "Chub", "Chug", "Chum", "Cite", "City", "Clad", "Clam",
-    "Clan", "Claw", "Clay", "Clod", "Clog", "Clot", "Club", "Clue",
-    "Coal", "Coat", "Coca", "Cock", "Coco", "Cod",  "Coda", "Code",
-    "Cody", "Coed", "Cog",  "Coil", "Coin", "Coke", "Col",  "Cola",
-    "Cold", "Colt", "Coma", "Comb", "Come", "Con",  "Coo",  "Cook",
-    "Cool", "Coon", "Coot", "Cop",  "Cord", "Core", "Cork", "Corn",
-    "Cost", "Cot",  "Cove", "Cow",  "Cowl", "Coy",  "Crab", "Crag",
-    "Cram", "Cray", "Crew", "Crib", "Crow", "Crud", "Cry",  "Cub",
-    "Cuba", "Cube", "Cue",  "Cuff", "Cull", "Cult", "Cuny", "Cup",
-    "Cur",  "Curb", "Curd", "Cure", "Curl", "Curt", "Cut",  "Cuts",
-    "Dab",  "Dad",  "Dade", "Dale", "Dam",  "Dame", "Dan",  "Dana",
-    "Dane", "Dang", "Dank", "Dar",  "Dare", "Dark", "Darn", "Dart",
-    "Dash", "Data", "Date", "Dave", "Davy", "Dawn", "Day",  "Days",
-    "Dead", "Deaf", "Deal", "Dean", "Dear", "Debt", "Deck", "Dee",
-    "Deed", "Deem", "Deep", "Deer", "Deft", "Defy", "Del",  "Dell",
-    "Den",  "Dent", "Deny", "Des",  "Desk", "Dew",  "Dial", "Dice",
-    "Did",  "Die",  "Died", "Diet", "Dig",  "Dime", "Din",  "Dine",
-    "Ding", "Dint", "Dip",  "Dire", "Dirt", "Disc", "Dish", "Disk",
-    "Dive", "Dock", "Doe",  "Does", "Dog",  "Dole", "Doll", "Dolt",
-    "Dome", "Don",  "Done", "Doom", "Door", "Dora", "Dose", "Dot",
-    "Dote", "Doug", "Dour", "Dove", "Dow",  "Down", "Drab", "Drag",
-    "Dram", "Draw", "Drew", "Drop", "Drub", "Drug", "Drum", "Dry",
-    "Dual", "Dub",  "Duck", "Duct", "Dud",  "Due",  "Duel", "Duet",
-    "Dug",  "Duke", "Dull", "Dumb", "Dun",  "Dune", "Dunk", "Dusk",
-    "Dust", "Duty", "Each", "Ear",  "Earl", "Earn", "Ease", "East",
-    "Easy", "Eat",  "Eben", "Echo", "Eddy", "Eden", "Edge", "Edgy",
-    "Edit", "Edna", "Eel",  "Egan", "Egg",  "Ego",  "Elan", "Elba",
-    "Eli",  "Elk",  "Ella", "Elm",  "Else", "Ely",  "Emil", "Emit",
-    "Emma", "End",  "Ends", "Eric", "Eros", "Est",  "Etc",  "Eva",
-    "Eve",  "Even", "Ever", "Evil", "Ewe",  "Eye",  "Eyed", "Face",
-    "Fact", "Fad",  "Fade", "Fail", "Fain", "Fair", "Fake", "Fall",
-    "Fame", "Fan",  "Fang", "Far",  "Farm", "Fast", "Fat",  "Fate",
-    "Fawn", "Fay",  "Fear", "Feat", "Fed",  "Fee",  "Feed", "Feel",
-    "Feet", "Fell", "Felt", "Fend", "Fern", "Fest", "Feud", "Few",
-    "Fib",  "Fief", "Fig",  "Figs", "File", "Fill", "Film", "Fin",
-    "Find", "Fine", "Fink", "Fir",  "Fire", "Firm", "Fish", "Fisk",
-    "Fist", "Fit",  "Fits", "Five", "Fix",  "Flag", "Flak", "Flam",
-    "Flat", "Flaw", "Flea", "Fled", "Flew", "Flit", "Flo",  "Floc",
-    "Flog", "Flow", "Flub", "Flue", "Fly",  "Foal", "Foam", "Foe",
-    "Fog",  "Fogy", "Foil", "Fold", "Folk", "Fond", "Font", "Food",
-    "Fool", "Foot", "For",  "Ford", "Fore", "Fork", "Form", "Fort",
-    "Foss", "Foul", "Four", "Fowl", "Fox",  "Frau", "Fray", "Fred",
-    "Free", "Fret", "Frey", "Frog", "From", "Fry",  "Fuel", "Full",
-    "Fum",  "Fume", "Fun",  "Fund", "Funk", "Fur",  "Fury", "Fuse",
-    "Fuss", "Gab",  "Gad",  "Gaff", "Gag",  "Gage", "Gail", "Gain",
-    "Gait", "Gal",  "Gala", "Gale", "Gall", "Galt", "Gam",  "Game",
-    "Gang", "Gap",  "Garb", "Gary", "Gas",  "Gash", "Gate", "Gaul",
-    "Gaur", "Gave", "Gawk", "Gay",  "Gear", "Gee",  "Gel",  "Geld",
-    "Gem",  "Gene", "Gent", "Germ", "Get",  "Gets", "Gibe", "Gift",
-    "Gig",  "Gil",  "Gild", "Gill", "Gilt", "Gin",  "Gina", "Gird",
-    "Girl", "Gist", "Give", "Glad", "Glee", "Glen", "Glib", "Glob",
-    "Glom", "Glow", "Glue", "Glum", "Glut", "Goad", "Goal", "Goat",
-    "God",  "Goer", "Goes", "Gold", "Golf", "Gone", "Gong", "Good",
-    "Goof", "Gore", "Gory", "Gosh", "Got",  "Gout", "Gown", "Grab",
-    "Grad", "Gray", "Greg", "Grew", "Grey", "Grid", "Grim", "Grin",
-    "Grit", "Grow", "Grub", "Gulf", "Gull", "Gum",  "Gun",  "Gunk",
-    "Guru", "Gus",  "Gush", "Gust", "Gut",  "Guy",  "Gwen", "Gwyn",
-    "Gym",  "Gyp",  "Haag", "Haas", "Hack", "Had",  "Hail", "Hair",
-    "Hal",  "Hale", "Half", "Hall", "Halo", "Halt", "Ham",  "Han",
-    "Hand", "Hang", "Hank", "Hans", "Hap",  "Hard", "Hark", "Harm",
-    "Hart", "Has",  "Hash", "Hast", "Hat",  "Hate", "Hath", "Haul",
-    "Have", "Haw",  "Hawk", "Hay",  "Hays", "Head", "Heal", "Hear",
-    "Heat", "Hebe", "Heck", "Heed", "Heel", "Heft", "Held", "Hell",
-    "Helm", "Help", "Hem",  "Hen",  "Her",  "Herb", "Herd", "Here",
-    "Hero", "Hers", "Hess", "Hew",  "Hewn", "Hey",  "Hick", "Hid",
-    "Hide", "High", "Hike", "Hill", "Hilt", "Him",  "Hind", "Hint",
-    "Hip",  "Hire", "His",  "Hiss", "Hit",  "Hive", "Hob",  "Hobo",
-    "Hoc",  "Hock", "Hoe",  "Hoff", "Hog",  "Hold", "Hole", "Holm",
-    "Holt", "Home", "Hone", "Honk", "Hood", "Hoof", "Hook", "Hoot",
-    "Hop",  "Hope", "Horn", "Hose", "Host", "Hot",  "Hour", "Hove",
-    "How",  "Howe", "Howl", "Hoyt", "Hub",  "Huck", "Hue",  "Hued",
-    "Huff", "Hug",  "Huge", "Hugh", "Hugo", "Huh",  "Hulk", "Hull",
-    "Hum",  "Hunk", "Hunt", "Hurd", "Hurl", "Hurt", "Hush", "Hut",
-    "Hyde", "Hymn", "Ibis", "Ice",  "Icon", "Icy",  "Ida",  "Idea",
-    "Idle", "Iffy", "Ike",  "Ill",  "Inca", "Inch", "Ink",  "Inn",
-    "Into", "Ion",  "Ions", "Iota", "Iowa", "Ira",  "Ire",  "Iris",
-    "Irk",  "Irma", "Iron", "Isle", "Itch", "Item", "Its",  "Ivan",
-    "Ivy",  "Jab",  "Jack", "Jade", "Jag",  "Jail", "Jake", "Jam",
-    "Jan",  "Jane", "Jar",  "Java", "Jaw",  "Jay",  "Jean", "Jeff",
-    "Jerk", "Jess", "Jest", "Jet",  "Jibe", "Jig",  "Jill", "Jilt",
-    "Jim",  "Jive", "Joan", "Job",  "Jobs", "Jock", "Joe",  "Joel",
-    "Joey", "Jog",  "John", "Join", "Joke", "Jolt", "Jot",  "Jove",
-    "Joy",  "Judd", "Jude", "Judo", "Judy", "Jug",  "Juju", "Juke",
-    "July", "Jump", "June", "Junk", "Juno", "Jury", "Just", "Jut",
-    "Jute", "Kahn", "Kale", "Kane", "Kant", "Karl", "Kate", "Kay",
-    "Keel", "Keen", "Keep", "Keg",  "Ken",  "Keno", "Kent", "Kern",
-    "Kerr", "Key",  "Keys", "Kick", "Kid",  "Kill", "Kim",  "Kin",
-    "Kind", "King", "Kirk", "Kiss", "Kit",  "Kite", "Klan", "Knee",
-    "Knew", "Knit", "Knob", "Knot", "Know", "Koch", "Kong", "Kudo",
-    "Kurd", "Kurt", "Kyle", "Lab",  "Lac",  "Lace", "Lack", "Lacy",
-    "Lad",  "Lady", "Lag",  "Laid", "Lain", "Lair", "Lake", "Lam",
-    "Lamb", "Lame", "Lamp", "Land", "Lane", "Lang", "Lap",  "Lard",
-    "Lark", "Lass", "Last", "Late", "Laud", "Lava", "Law",  "Lawn",
-    "Laws", "Lay",  "Lays", "Lazy", "Lea",  "Lead", "Leaf", "Leak",
-    "Lean", "Lear", "Led",  "Lee",  "Leek", "Leer", "Left", "Leg",
-    "Len",  "Lend", "Lens", "Lent", "Leo",  "Leon", "Lesk", "Less",
-    "Lest", "Let",  "Lets", "Lew",  "Liar", "Lice", "Lick", "Lid",
-    "Lie",  "Lied", "Lien", "Lies", "Lieu", "Life", "Lift", "Like",
-    "Lila", "Lilt", "Lily", "Lima", "Limb", "Lime", "Lin",  "Lind",
-    "Line", "Link", "Lint", "Lion", "Lip",  "Lisa", "List", "Lit",
-    "Live", "Load", "Loaf", "Loam", "Loan", "Lob",  "Lock", "Loft",
-    "Log",  "Loge", "Lois", "Lola", "Lone", "Long", "Look", "Loon",
-    "Loot", "Lop",  "Lord", "Lore", "Los",  "Lose", "Loss", "Lost",
-    "Lot",  "Lou",  "Loud", "Love", "Low",  "Lowe", "Loy",  "Luck",
-    "Lucy", "Lug",  "Luge", "Luke", "Lulu", "Lund", "Lung", "Lura",
-    "Lure", "Lurk", "Lush", "Lust", "Lye",  "Lyle", "Lynn", "Lyon",
-    "Lyra", "Mac",  "Mace", "Mad",  "Made", "Mae",  "Magi", "Maid",
-    "Mail", "Main", "Make", "Male", "Mali", "Mall", "Malt", "Man",
-    "Mana", "Mann", "Many", "Mao",  "Map",  "Marc", "Mare", "Mark",
-    "Mars", "Mart", "Mary", "Mash", "Mask", "Mass", "Mast", "Mat",
-    "Mate", "Math", "Maul", "Maw",  "May",  "Mayo", "Mead", "Meal",
-    "Mean", "Meat", "Meek", "Meet", "Meg",  "Mel",  "Meld", "Melt",
-    "Memo", "Men",  "Mend", "Menu", "Mert", "Mesh", "Mess", "Met",
-    "Mew",  "Mice", "Mid",  "Mike", "Mild", "Mile", "Milk", "Mill",
-    "Milt", "Mimi", "Min",  "Mind", "Mine", "Mini", "Mink", "Mint",
-    "Mire", "Miss", "Mist", "Mit",  "Mite", "Mitt", "Mix",  "Moan",
-    "Moat", "Mob",  "Mock", "Mod",  "Mode", "Moe",  "Mold", "Mole",
-    "Moll", "Molt", "Mona", "Monk", "Mont", "Moo",  "Mood", "Moon",
-    "Moor", "Moot", "Mop",  "More", "Morn", "Mort", "Mos",  "Moss",
-    "Most", "Mot",  "Moth", "Move", "Mow",  "Much", "Muck", "Mud",
-    "Mudd", "Muff", "Mug",  "Mule", "Mull", "Mum",  "Murk", "Mush",
-    "Must", "Mute", "Mutt", "Myra", "Myth", "Nab",  "Nag",  "Nagy",
-    "Nail", "Nair", "Name", "Nan",  "Nap",  "Nary", "Nash", "Nat",
-    "Nave", "Navy", "Nay",  "Neal", "Near", "Neat", "Neck", "Ned",
-    "Nee",  "Need", "Neil", "Nell", "Neon", "Nero", "Ness", "Nest",
-    "Net",  "New",  "News", "Newt", "Next", "Nib",  "Nibs", "Nice",
-    "Nick", "Nil",  "Nile", "Nina", "Nine", "Nip",  "Nit",  "Noah",
-    "Nob",  "Nod",  "Node", "Noel", "Noll", "Non",  "None", "Nook",
-    "Noon", "Nor",  "Norm", "Nose", "Not",  "Note", "Noun", "Nov",
-    "Nova", "Now",  "Nude", "Null", "Numb", "Nun",  "Nut",  "Oaf",
-    "Oak",  "Oar",  "Oat",  "Oath", "Obey", "Oboe", "Odd",  "Ode",
-    "Odin", "Off",  "Oft",  "Ohio", "Oil",  "Oily", "Oint", "Okay",
-    "Olaf", "Old",  "Oldy", "Olga", "Olin", "Oman", "Omen", "Omit",
-    "Once", "One",  "Ones", "Only", "Onto", "Onus", "Open", "Oral",
-    "Orb",  "Ore",  "Orgy", "Orr",  "Oslo", "Otis", "Ott",  "Otto",
-    "Ouch", "Our",  "Oust", "Out",  "Outs", "Ova",  "Oval", "Oven",
-    "Over", "Owe",  "Owl",  "Owly", "Own",  "Owns", "Pad",  "Page",
-    "Pain", "Pair", "Pal",  "Pam",  "Pan",  "Pap",  "Par",  "Park",
-    "Part", "Pass", "Past", "Pat",  "Path", "Paw",  "Pay",  "Pea",
-    "Peg",  "Pen",  "Pep",  "Per",  "Pet",  "Pew",  "Phi",  "Pick",
-    "Pie",  "Pig",  "Pin",  "Pink", "Pit",  "Play", "Ply",  "Pod",
-    "Poe",  "Pool", "Poor", "Pop",  "Pot",  "Pour", "Pow",  "Pro",
-    "Pry",  "Pub",  "Pug",  "Pull", "Pun",  "Pup",  "Push", "Put",
-    "Quad", "Quit", "Quo",  "Quod", "Race", "Rack", "Racy", "Raft",
-    "Rag",  "Rage", "Raid", "Rail", "Rain", "Rake", "Ram",  "Ran",
-    "Rank", "Rant", "Rap",  "Rare", "Rash", "Rat",  "Rate", "Rave",
-    "Raw",  "Ray",  "Rays", "Read", "Real", "Ream", "Rear", "Reb",
-    "Reck", "Red",  "Reed", "Reef", "Reek", "Reel", "Reid", "Rein",
-    "Rena", "Rend", "Rent", "Rep",  "Rest", "Ret",  "Rib",  "Rice",
-    "Rich", "Rick", "Rid",  "Ride", "Rift", "Rig",  "Rill", "Rim",
-    "Rime", "Ring", "Rink", "Rio",  "Rip",  "Rise", "Risk", "Rite",
-    "Road", "Roam", "Roar", "Rob",  "Robe", "Rock", "Rod",  "Rode",
-    "Roe",  "Roil", "Roll", "Rome", "Ron",  "Rood", "Roof", "Rook",
-    "Room", "Root", "Rosa", "Rose", "Ross", "Rosy", "Rot",  "Roth",
-    "Rout", "Rove", "Row",  "Rowe", "Rows", "Roy",  "Rub",  "Rube",
-    "Ruby", "Rude", "Rudy", "Rue",  "Rug",  "Ruin", "Rule", "Rum",
-    "Run",  "Rung", "Runs", "Runt", "Ruse", "Rush", "Rusk", "Russ",
-    "Rust", "Ruth", "Rye",  "Sac",  "Sack", "Sad",  "Safe", "Sag",
-    "Sage", "Said", "Sail", "Sal",  "Sale", "Salk", "Salt", "Sam",
-    "Same", "San",  "Sand", "Sane", "Sang", "Sank", "Sap",  "Sara",
-    "Sat",  "Saul", "Save", "Saw",  "Say",  "Says", "Scan", "Scar",
-    "Scat", "Scot", "Sea",  "Seal", "Seam", "Sear", "Seat", "Sec",
-    "See",  "Seed", "Seek", "Seem", "Seen", "Sees", "Self", "Sell",
-    "Sen",  "Send", "Sent", "Set",  "Sets", "Sew",  "Sewn", "Sex",
-    "Shag", "Sham", "Shaw", "Shay", "She",  "Shed", "Shim", "Shin",
-    "Ship", "Shod", "Shoe", "Shop", "Shot", "Show", "Shun", "Shut",
-    "Shy",  "Sick", "Side", "Sift", "Sigh", "Sign", "Silk", "Sill",
-    "Silo", "Silt", "Sin",  "Sine", "Sing", "Sink", "Sip",  "Sir",
-    "Sire", "Sis",  "Sit",  "Site", "Sits", "Situ", "Six",  "Size",
-    "Skat", "Skew", "Ski",  "Skid", "Skim", "Skin", "Skit", "Sky",
-    "Slab", "Slam", "Slat", "Slay", "Sled", "Slew", "Slid", "Slim",
-    "Slip", "Slit", "Slob", "Slog", "Slot", "Slow", "Slug", "Slum",
-    "Slur", "Sly",  "Smog", "Smug", "Snag", "Snob", "Snow", "Snub",
-    "Snug", "Soak", "Soap", "Soar", "Sob",  "Sock", "Sod",  "Soda",
-    "Sofa", "Soft", "Soil", "Sold", "Some", "Son",  "Song", "Soon",
-    "Soot", "Sop",  "Sore", "Sort", "Soul", "Soup", "Sour", "Sow",
-    "Sown", "Soy",  "Spa",  "Spy",  "Stab", "Stag", "Stan", "Star",
-    "Stay", "Stem", "Step", "Stew", "Stir", "Stop", "Stow", "Stub",
-    "Stun", "Sub",  "Such", "Sud",  "Suds", "Sue",  "Suit", "Sulk",
-    "Sum",  "Sums", "Sun",  "Sung", "Sunk", "Sup",  "Sure", "Surf",
-    "Swab", "Swag", "Swam", "Swan", "Swat", "Sway", "Swim", "Swum",
-    "Tab",  "Tack", "Tact", "Tad",  "Tag",  "Tail", "Take", "Tale",
-    "Talk", "Tall", "Tan",  "Tank", "Tap",  "Tar",  "Task", "Tate",
-    "Taut", "Taxi", "Tea",  "Teal", "Team", "Tear", "Tech", "Ted",
-    "Tee",  "Teem", "Teen", "Teet", "Tell", "Ten",  "Tend", "Tent",
-    "Term", "Tern", "Tess", "Test", "Than", "That", "The",  "Thee",
-    "Them", "Then", "They", "Thin", "This", "Thud", "Thug", "Thy",
-    "Tic",  "Tick", "Tide", "Tidy", "Tie",  "Tied", "Tier", "Tile",
-    "Till", "Tilt", "Tim",  "Time", "Tin",  "Tina", "Tine", "Tint",
-    "Tiny", "Tip",  "Tire", "Toad", "Toe",  "Tog",  "Togo", "Toil",
-    "Told", "Toll", "Tom",  "Ton",  "Tone", "Tong", "Tony", "Too",
-    "Took", "Tool", "Toot", "Top",  "Tore", "Torn", "Tote", "Tour",
-    "Tout", "Tow",  "Town", "Toy",  "Trag", "Tram", "Tray", "Tree",
-    "Trek", "Trig", "Trim", "Trio", "Trod", "Trot", "Troy", "True",
-    "Try",  "Tub",  "Tuba", "Tube", "Tuck", "Tuft", "Tug",  "Tum",
-    "Tun",  "Tuna", "Tune", "Tung", "Turf", "Turn", "Tusk", "Twig",
-    "Twin", "Twit", "Two",  "Type", "Ugly", "Ulan", "Unit", "Urge",
-    "Use",  "Used", "User", "Uses", "Utah", "Vail", "Vain", "Vale",
-    "Van",  "Vary", "Vase", "Vast", "Vat",  "Veal", "Veda", "Veil",
-    "Vein", "Vend", "Vent", "Verb", "Very", "Vet",  "Veto", "Vice",
-    "Vie",  "View", "Vine", "Vise", "Void", "Volt", "Vote", "Wack",
-    "Wad",  "Wade", "Wag",  "Wage", "Wail", "Wait", "Wake", "Wale",
-    "Walk", "Wall", "Walt", "Wand", "Wane", "Wang", "Want", "War",
-    "Ward", "Warm", "Warn", "Wart", "Was",  "Wash", "Wast", "Wats",
-    "Watt", "Wave", "Wavy", "Way",  "Ways", "Weak", "Weal", "Wean",
-    "Wear", "Web",  "Wed",  "Wee",  "Weed", "Week", "Weir", "Weld",
-    "Well", "Welt", "Went", "Were", "Wert", "West", "Wet",  "Wham",
-    "What", "Whee", "When", "Whet", "Who",  "Whoa", "Whom", "Why",
-    "Wick", "Wide", "Wife", "Wild", "Will", "Win",  "Wind", "Wine",
-    "Wing", "Wink", "Wino", "Wire", "Wise", "Wish", "Wit",  "With",
-    "Wok",  "Wolf", "Won",  "Wont", "Woo",  "Wood", "Wool", "Word",
-    "Wore", "Work", "Worm", "Worn", "Wove", "Wow",  "Writ", "Wry",
-    "Wynn", "Yale", "Yam",  "Yang", "Yank", "Yap",  "Yard", "Yarn",
-    "Yaw",  "Yawl", "Yawn", "Yea",  "Yeah", "Year", "Yell", "Yes",
-    "Yet",  "Yoga", "Yoke", "You",  "Your", "Zap",  "Zero", "Zoo"
+    while ((len = getline(&line, &cap, stdin)) > 0) {
+        lineno++;
+        got = mkpasswd_decode(dict, line, len, idx, MKPASSWD_MAX_WORDS);
+        if (got != (ssize_t)nw) {
+            fprintf(stderr, "mkpasswd : line %lu: not a %u-word "
+                "passphrase\n", lineno, nw);
+            status = EINVAL;
+            continue;
+        }
+        if (o->size - o->len < (size_t)(nw * k + 7) / 8 * 2 + 1)
+            out_flush(o);
+        p = put_tuple(o->buf + o->len, idx, nw, k);
+        *p++ = '\n';
+        o->len = p - o->buf;
+    }
+    if (ferror(stdin))
+        fail("read error");
+    memset(idx, 0, sizeof(idx));
+    free(line);
+    return status;
+}
+
+static const char *const caps[] = { "asis", "all", "first", "none" };
+
+/*
+ *  Whether phrases run together can be split more than one way.
+ *  Once --capitalize has changed the case only the case-folded
+ *  test holds, but for the capitals the built-in words have anyway.
+ */
+static int
+ambiguous(const mkpasswd_dict *dict, char sep, int cap) {
+    struct mkpasswd_dict_info   di;
+
+    mkpasswd_dict_get_info(dict, &di);
+    if (sep != 0 || di.decodable_nocase)
+        return 0;
+    return !di.decodable || !(cap == MKPASSWD_CAP_ASIS ||
+        (dict == NULL && cap == MKPASSWD_CAP_ALL));
+}
+
+/*
+ *  --info: what the word list stored about itself, and what that
+ *  makes a phrase worth, under the policy if there is one.
+ */
+static void
+info(const mkpasswd_dict *dict, const char *path, unsigned nw, char sep,
+    const mkpasswd_policy *pol, const struct mkpasswd_policy_conf *pc) {
+    struct mkpasswd_dict_info   di;
+    double      bits;
+
+    mkpasswd_dict_get_info(dict, &di);
+    bits = pol != NULL ? mkpasswd_policy_entropy_bits(pol) :
+        mkpasswd_dict_entropy_bits(dict, nw);
+    printf("dictionary=%s\n", path != NULL ? path : "built-in");
+    printf("words=%zu\n", di.words);
+    printf("word_bytes=%u-%u\n", di.minlen, di.maxlen);
+    printf("unique=%s\n", di.unique ? "yes" : "no");
+    printf("decodable=%s\n", di.decodable ? "yes" : "no");
+    printf("decodable_nocase=%s\n", di.decodable_nocase ? "yes" : "no");
+    printf("hashed=%s\n", di.hashed ? "yes" : "no");
+    printf("bits_per_word=%.2f\n", di.bits);
+    printf("words_per_phrase=%u\n", nw);
+    if (pol != NULL) {
+        if (pc->max_len != 0)
+            printf("max_len=%u\n", pc->max_len);
+        printf("digit=%s\n", pc->digit ? "yes" : "no");
+        printf("symbol=%s\n", pc->symbol ? "yes" : "no");
+        printf("capitalize=%s\n", caps[pc->capitalize]);
+    }
+    /* run together ambiguously, some phrases have several spellings */
+    if (ambiguous(dict, sep, pc->capitalize))
+        printf("bits_per_phrase=<%.2f\n", bits);
+    else
+        printf("bits_per_phrase=%.2f\n", bits);
+}
+
+#define	SEED_CHECK_COUNT	(2 * CHUNK + 123)
+
+/* how seeded_run() makes its phrases */
+struct seeded_opts {
+    const char      *kernel;
+    size_t          bufsize;
+    unsigned        nthr, shard, nshards;
+    struct bloom    *dedup;
+    unsigned long long  dups;           /* out: phrases dropped */
+};
+
+/*
+ *  SEED_CHECK_COUNT phrases from a fixed seed with the kernel,
+ *  entropy buffer size, thread count and shard of so, read back
+ *  from a temporary file into a buffer the caller frees.  NULL if
+ *  this CPU lacks the kernel.
+ */
+static char *
+seeded_run(struct seeded_opts *so, size_t *len) {
+    static const unsigned char  key[32] = "mkpasswd --selftest --seed key.";
+    mkpasswd_ctx            c;
+    struct mkpasswd_stats   st;
+    struct format           f = { FMT_RAW, 0, 0, "", 0, NULL, NULL, 0, NULL };
+    struct outbuf           o;
+    unsigned char           *eb;
+    char                    *text;
+    FILE                    *fp;
+    long                    n;
+    int                     fd;
+
+    eb = xsecure(so->bufsize);
+    if (mkpasswd_init(&c, 0, eb, so->bufsize) != 0)
+        fail("unable to set up generator");
+    if (mkpasswd_set_kernel(&c, so->kernel) != 0) {
+        if (errno != ENOTSUP)
+            fail(so->kernel);
+        mkpasswd_secure_free(eb, so->bufsize);
+        return NULL;
+    }
+    format_init(&f, NULL, MKPASSWD_WORDS, '-');
+    f.dedup = so->dedup;
+    if ((fp = tmpfile()) == NULL || (fd = dup(fileno(fp))) < 0)
+        fail("temporary file");
+    out_plan(&o, fd, format_room(&f, NULL, BATCH, MKPASSWD_WORDS), 0);
+    out_alloc(&o);
+    if (so->nthr > 1)
+        generate_threaded(&c, NULL, &o, &f, &st, 0, 0, so->bufsize,
+            SEED_CHECK_COUNT, MKPASSWD_WORDS, '-', so->nthr, key,
+            so->shard, so->nshards, 0);
+    else
+        generate_chunks(&c, NULL, &o, &f, SEED_CHECK_COUNT, MKPASSWD_WORDS,
+            '-', key, so->shard, so->nshards);
+    so->dups = o.dups;
+    out_close(&o);
+    if (fseek(fp, 0, SEEK_END) != 0 || (n = ftell(fp)) < 0)
+        fail("temporary file");
+    rewind(fp);
+    text = xmalloc(n + 1);
+    if (fread(text, 1, n, fp) != (size_t)n)
+        fail("temporary file");
+    fclose(fp);
+    mkpasswd_destroy(&c);
+    mkpasswd_secure_free(eb, so->bufsize);
+    *len = n;
+    return text;
+}
+
+/*
+ *  Known phrases of seeded_run(), first, first of the second chunk
+ *  and last, so that the seeded stream itself cannot drift: a
+ *  change here breaks every recorded load test.
+ */
+static int
+seed_golden(const char *text, size_t len) {
+    static const struct {
+        size_t      line;
+        const char  *phrase;
+    } golden[] = {
+        { 0,                    "Came-Bunk-Slug-Clue-Gag-Seed\n" },
+        { CHUNK,                "Jet-Cal-Ate-Glum-Fern-Reb\n" },
+        { SEED_CHECK_COUNT - 1, "Ron-Owly-Gave-Ate-Tide-Flat\n" },
+    };
+    const char  *p = text, *end = text + len;
+    size_t      i, line = 0;
+
+    for (i = 0; i < sizeof(golden) / sizeof(golden[0]); i++) {
+        for (; line < golden[i].line && p < end; line++)
+            if ((p = memchr(p, '\n', end - p)) != NULL)
+                p++;
+            else
+                return 1;
+        if ((size_t)(end - p) < strlen(golden[i].phrase) ||
+            memcmp(p, golden[i].phrase, strlen(golden[i].phrase)) != 0)
+            return 1;
+    }
+    return 0;
+}
+
+/*
+ *  --seed output must not depend on the kernel, the buffer size or
+ *  the thread count, or it could not be used to compare them.  The
+ *  shards of a run, one after another, must be the chunks of the
+ *  run; and --dedup must pass a run it has not seen and drop all of
+ *  one it has.
+ */
+static int
+selftest_seeded(void) {
+    static const struct {
+        size_t      bufsize;
+        unsigned    nthr;
+    } runs[] = { { 100, 1 }, { ENTROPY_BUFSIZE, 3 }, { 64, 4 } };
+    struct seeded_opts  so = { "scalar", ENTROPY_BUFSIZE, 1, 0, 1, NULL, 0 };
+    const char  *p, *e, *chunk[3];
+    char        *ref, *got;
+    size_t      i, rlen, glen;
+    int         bad = 0, r;
+
+    ref = seeded_run(&so, &rlen);
+    r = seed_golden(ref, rlen);
+    printf("seeded golden: %s\n", r ? "FAIL" : "ok");
+    bad |= r;
+    for (i = 0; (so.kernel = mkpasswd_kernel_name(i)) != NULL; i++) {
+        if (strcmp(so.kernel, "scalar") == 0 ||
+            (got = seeded_run(&so, &glen)) == NULL)
+            continue;
+        r = glen != rlen || memcmp(ref, got, rlen) != 0;
+        printf("seeded %s: %s\n", so.kernel, r ? "FAIL" : "ok");
+        bad |= r;
+        free(got);
+    }
+    so.kernel = "scalar";
+    for (i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        so.bufsize = runs[i].bufsize;
+        so.nthr = runs[i].nthr;
+        got = seeded_run(&so, &glen);
+        r = glen != rlen || memcmp(ref, got, rlen) != 0;
+        printf("seeded -b %zu -j %u: %s\n", so.bufsize, so.nthr,
+            r ? "FAIL" : "ok");
+        bad |= r;
+        free(got);
+    }
+
+    /* the three chunks of the run, and the shards that make them */
+    for (p = ref, i = 0; i < 3; i++) {
+        chunk[i] = p;
+        for (glen = 0; glen < CHUNK && p != NULL; glen++)
+            if ((p = memchr(p, '\n', ref + rlen - p)) != NULL)
+                p++;
+    }
+    so.bufsize = ENTROPY_BUFSIZE;
+    for (r = 0, so.nshards = 2; so.nshards <= 3; so.nshards++)
+        for (so.shard = 0; so.shard < so.nshards; so.shard++) {
+            so.nthr = 1 + so.shard;
+            got = seeded_run(&so, &glen);
+            /* shard k of n makes chunks k, k + n, ... */
+            for (p = got, i = so.shard; i < 3; i += so.nshards) {
+                e = i < 2 ? chunk[i + 1] : ref + rlen;
+                r |= (size_t)(got + glen - p) < (size_t)(e - chunk[i]) ||
+                    memcmp(p, chunk[i], e - chunk[i]) != 0;
+                p += e - chunk[i];
+            }
+            r |= p != got + glen;
+            free(got);
+        }
+    printf("seeded --shard: %s\n", r ? "FAIL" : "ok");
+    bad |= r;
+
+    so.shard = 0;
+    so.nshards = 1;
+    so.nthr = 3;
+    so.dedup = bloom_create(DEDUP_MB);
+    got = seeded_run(&so, &glen);
+    r = so.dups != 0 || glen != rlen || memcmp(ref, got, rlen) != 0;
+    free(got);
+    got = seeded_run(&so, &glen);
+    /* drawing on, the chunk's stream makes none of the run again */
+    r |= so.dups < SEED_CHECK_COUNT;
+    printf("seeded --dedup: %s\n", r ? "FAIL" : "ok");
+    bad |= r;
+    free(got);
+    bloom_destroy(so.dedup);
+    free(ref);
+    return bad;
+}
+
+#define	POLICY_CHECK_COUNT	4096
+#define	POLICY_CHECK_LEN	26
+
+/*
+ *  The phrase counts behind --max-len, against the word lengths
+ *  they imply: two words in 6 letters are two of three letters, in
+ *  8 any two, so in 7 there must be n3^2 + 2 n3 n4 of them.  Then
+ *  phrases made under every policy at once must keep to each.
+ */
+static int
+selftest_policy(void) {
+    struct mkpasswd_policy_conf pc;
+    mkpasswd_policy *pol;
+    mkpasswd_ctx    c;
+    double          b[3], n3, n4;
+    char            *buf, *p, *q, *nl, *end;
+    size_t          size, longest = 0;
+    ssize_t         len;
+    unsigned        i, digits, symbols, w;
+    int             r, bad, start;
+
+    memset(&pc, 0, sizeof(pc));
+    pc.nwords = 2;
+    for (i = 0; i < 3; i++) {
+        pc.max_len = 6 + i;
+        if ((pol = mkpasswd_policy_create(NULL, &pc)) == NULL)
+            fail("unable to set up policy");
+        b[i] = mkpasswd_policy_entropy_bits(pol);
+        mkpasswd_policy_destroy(pol);
+    }
+    n3 = exp2(b[0] / 2);
+    n4 = exp2(b[2] / 2) - n3;
+    r = fabs(exp2(b[1]) - (n3 * n3 + 2 * n3 * n4)) > 0.5;
+    printf("policy counts: %s\n", r ? "FAIL" : "ok");
+    bad = r;
+    r = 0;
+
+    pc.nwords = MKPASSWD_WORDS;
+    pc.sep = '-';
+    pc.max_len = POLICY_CHECK_LEN;
+    pc.digit = pc.symbol = 1;
+    pc.capitalize = MKPASSWD_CAP_FIRST;
+    if ((pol = mkpasswd_policy_create(NULL, &pc)) == NULL ||
+        mkpasswd_init(&c, 0, NULL, 0) != 0)
+        fail("unable to set up policy");
+    size = mkpasswd_policy_batch_size(pol, POLICY_CHECK_COUNT);
+    buf = xmalloc(size);
+    if ((len = mkpasswd_generate_policy(&c, pol, buf, size,
+        POLICY_CHECK_COUNT, NULL)) < 0)
+        fail("unable to read entropy");
+    for (p = buf, end = buf + len; p < end; p = nl + 1) {
+        nl = memchr(p, '\n', end - p);
+        if ((size_t)(nl - p) > longest)
+            longest = nl - p;
+        digits = symbols = w = 0;
+        for (q = p, start = 1; q < nl; q++)
+            if ((unsigned)(*q - '0') < 10u)
+                digits++;
+            else if (memchr("!#$%&*?@", *q, 8) != NULL)
+                symbols++;
+            else if (*q == '-')
+                start = 1;
+            else if (start) {
+                r |= (w++ == 0) != ((unsigned)(*q - 'A') < 26u);
+                start = 0;
+            }
+        r |= digits != 1 || symbols != 1 || w != MKPASSWD_WORDS;
+    }
+    /* seven in eight phrases have two four-letter words and fill it */
+    r |= longest != POLICY_CHECK_LEN;
+    printf("policy phrases: %s\n", r ? "FAIL" : "ok");
+    mkpasswd_secure_wipe(buf, size);
+    free(buf);
+    mkpasswd_destroy(&c);
+    mkpasswd_policy_destroy(pol);
+    return bad | r;
+}
+
+#define	POLICY_DEDUP_COUNT	8192
+
+/*
+ *  Under a digit and a symbol one word is 80 phrases, so --dedup
+ *  over POLICY_DEDUP_COUNT of them, four times the words there
+ *  are, must drop only the few made twice, keep nothing a second
+ *  filter has seen, and drop all of them once they are seen.
+ */
+static int
+selftest_policy_dedup(void) {
+    struct mkpasswd_policy_conf pc;
+    mkpasswd_policy *pol;
+    mkpasswd_ctx    c;
+    struct bloom    *b = bloom_create(1), *fresh = bloom_create(1);
+    uint32_t        *idx;
+    unsigned long long  dups = 0, again = 0;
+    char            *buf;
+    size_t          size, kept;
+    ssize_t         len;
+    int             r;
+
+    memset(&pc, 0, sizeof(pc));
+    pc.nwords = 1;
+    pc.digit = pc.symbol = 1;
+    if ((pol = mkpasswd_policy_create(NULL, &pc)) == NULL ||
+        mkpasswd_init(&c, 0, NULL, 0) != 0)
+        fail("unable to set up policy");
+    size = mkpasswd_policy_batch_size(pol, POLICY_DEDUP_COUNT);
+    buf = xmalloc(size);
+    idx = xmalloc(POLICY_DEDUP_COUNT * sizeof(*idx));
+    if ((len = mkpasswd_generate_policy(&c, pol, buf, size,
+        POLICY_DEDUP_COUNT, idx)) < 0)
+        fail("unable to read entropy");
+    kept = dedup(b, buf, &len, idx, POLICY_DEDUP_COUNT, 1, 1, &dups);
+    r = dups > POLICY_DEDUP_COUNT / 8;
+    r |= dedup(fresh, buf, &len, idx, kept, 1, 1, &again) != kept;
+    r |= dedup(b, buf, &len, idx, kept, 1, 1, &again) != 0;
+    printf("policy --dedup: %s\n", r ? "FAIL" : "ok");
+    mkpasswd_secure_wipe(buf, size);
+    free(buf);
+    free(idx);
+    mkpasswd_destroy(&c);
+    mkpasswd_policy_destroy(pol);
+    bloom_destroy(fresh);
+    bloom_destroy(b);
+    return r;
+}
+
+#define	PREFETCH_CHECK_COUNT	4096
+
+/*
+ *  Prefetch swaps buffers about, so a block handed out twice, or
+ *  one lost when it stops, would show as phrases made twice.  From
+ *  a 64-byte buffer, refilled every seven phrases, through a ring
+ *  of three, then none, then the CSPRNG's ring of two, no tuple may
+ *  come again.
+ */
+static int
+selftest_prefetch(void) {
+    static const struct {
+        int         flags;
+        unsigned    depth;
+    } runs[] = { { 0, 3 }, { 0, 0 }, { MKPASSWD_CSPRNG, 2 } };
+    struct bloom    *b = bloom_create(1);
+    struct mkpasswd_stats   st;
+    mkpasswd_ctx    c;
+    uint32_t        idx[BATCH * MKPASSWD_WORDS];
+    char            *buf;
+    size_t          size, i, j, k;
+    unsigned long long  dups = 0;
+    int             r;
+
+    size = mkpasswd_batch_size(BATCH, MKPASSWD_WORDS);
+    buf = xmalloc(size);
+    if (mkpasswd_init(&c, 0, NULL, 64) != 0)
+        fail("unable to set up generator");
+    for (i = 0; i < sizeof(runs) / sizeof(runs[0]); i++) {
+        if (runs[i].flags != 0) {
+            mkpasswd_destroy(&c);
+            if (mkpasswd_init(&c, runs[i].flags, NULL, 64) != 0)
+                fail("unable to set up generator");
+        }
+        if (mkpasswd_set_prefetch(&c, runs[i].depth) != 0)
+            fail("unable to start prefetch");
+        for (j = 0; j < PREFETCH_CHECK_COUNT; j += BATCH) {
+            if (mkpasswd_generate_batch_idx(&c, buf, size, BATCH,
+                MKPASSWD_WORDS, 0, idx) < 0)
+                fail("unable to read entropy");
+            for (k = 0; k < BATCH; k++)
+                dups += bloom_add(b, idx + k * MKPASSWD_WORDS,
+                    MKPASSWD_WORDS);
+        }
+    }
+    mkpasswd_get_stats(&c, &st);
+    mkpasswd_destroy(&c);
+    r = dups != 0 || st.refills == 0;
+    printf("prefetch: %s\n", r ? "FAIL" : "ok");
+    mkpasswd_secure_wipe(buf, size);
+    free(buf);
+    bloom_destroy(b);
+    return r;
+}
+
+/*
+ *  Check every vector kernel this CPU runs against the scalar one,
+ *  that seeded runs agree, the policies, with --dedup, and prefetch.
+ */
+static int
+selftest(mkpasswd_ctx *ctx) {
+    const char  *name;
+    size_t      i;
+    int         r, bad = 0;
+
+    for (i = 0; (name = mkpasswd_kernel_name(i)) != NULL; i++) {
+        if (strcmp(name, "scalar") == 0)
+            continue;
+        if ((r = mkpasswd_check_kernel(ctx, name)) < 0) {
+            if (errno == ENOTSUP)
+                continue;
+            fail("unable to read entropy");
+        }
+        printf("kernel %s: %s\n", name, r ? "FAIL" : "ok");
+        bad |= r;
+    }
+    return bad | selftest_seeded() | selftest_policy() |
+        selftest_policy_dedup() | selftest_prefetch();
+}
+
+
+/*
+ *  --seed: 256 bits as 64 hex digits.
+ */
+static void
+getseed(const char *arg, unsigned char key[32]) {
+    unsigned    i, d;
+    int         c;
+
+    if (strlen(arg) != 64) {
+        fprintf(stderr, "mkpasswd : --seed takes 64 hex digits\n");
+        exit(EINVAL);
+    }
+    for (i = 0; i < 64; i++) {
+        c = arg[i];
+        if (c >= '0' && c <= '9')
+            d = c - '0';
+        else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+            d = (c | 0x20) - 'a' + 10;
+        else {
+            fprintf(stderr, "mkpasswd : --seed takes 64 hex digits\n");
+            exit(EINVAL);
+        }
+        key[i / 2] = i & 1 ? key[i / 2] | d : d << 4;
+    }
+}
+
+/*
+ *  --shard K/N: this host's part, 1 to N, of a run split N ways.
+ */
+static void
+getshard(const char *arg, unsigned *shard, unsigned *nshards) {
+    unsigned long   k, n;
+    char            *ep;
+
+    errno = 0;
+    k = strtoul(arg, &ep, 10);
+    if (errno == 0 && ep != arg && *ep == '/' && *arg != '-' &&
+        ep[1] != '-') {
+        arg = ep + 1;
+        n = strtoul(arg, &ep, 10);
+        if (errno == 0 && ep != arg && *ep == '\0' && k >= 1 && k <= n &&
+            n <= MAX_SHARDS) {
+            *shard = k - 1;
+            *nshards = n;
+            return;
+        }
+    }
+    fprintf(stderr, "mkpasswd : --shard takes K/N, 1 <= K <= N <= %u\n",
+        MAX_SHARDS);
+    exit(EINVAL);
+}
+
+static unsigned long long
+getnum(const char *arg, const char *what,
+    unsigned long long lo, unsigned long long hi) {
+    unsigned long long  v;
+    char                *ep;
+
+    errno = 0;
+    v = strtoull(arg, &ep, 10);
+    if (errno != 0 || ep == arg || *ep != '\0' || *arg == '-' ||
+        v < lo || v > hi) {
+        fprintf(stderr, "mkpasswd : invalid %s %s\n", what, arg);
+        exit(EINVAL);
+    }
+    return v;
+}
+
+
+static void usage(int) __attribute__((__noreturn__));
+
+static void
+usage(int status) {
+    fprintf(stderr, "usage: mkpasswd [-dsh] [-f dict] [-n count] [-w words] "
+        "[-j threads] [-b bufsize] [-o file] [--fsync[=MB]]"
+        " [--mlock] [--csprng[=MB]] [--kernel name] [--sampler name]"
+        " [--format name [--indices]] [--stats]"
+        " [--seed hex --insecure]\n"
+        "                [--max-len n] [--digit] [--symbol] "
+        "[--capitalize how] [--shard k/n] [--dedup[=MB]]"
+        " [--prefetch[=n]]\n");
+    fprintf(stderr, "       mkpasswd [-ds] [-f dict] [-w words] "
+        "[--max-len n] [--digit] [--symbol]\n"
+        "                [--capitalize how] --info\n");
+    fprintf(stderr, "       mkpasswd [-f dict] [-w words] [-o file] "
+        "--decode\n");
+    fprintf(stderr, "       mkpasswd --backend | --selftest\n");
+    fprintf(stderr, "       mkpasswd [-ds] [-f dict] [-w words] "
+        "[--csprng[=MB]] [--kernel name] [--pool n] [--mlock]\n"
+        "                [--prefetch[=n]] --serve socket\n");
+    fprintf(stderr, "  -h : print this message\n");
+    fprintf(stderr, "  -d : delimit words with dashes\n");
+    fprintf(stderr, "  -s : delimit words with spaces\n");
+    fprintf(stderr, "  -f dict : take words from a dictionary made by "
+        "mkdict\n");
+    fprintf(stderr, "  -n count : generate count passphrases, "
+        "one per line\n");
+    fprintf(stderr, "  -w words : words per passphrase, 1 to %d "
+        "(default %d, %.0f bits)\n", MKPASSWD_MAX_WORDS, MKPASSWD_WORDS,
+        mkpasswd_entropy_bits(MKPASSWD_WORDS));
+    fprintf(stderr, "  -j threads : split the count across threads\n");
+    fprintf(stderr, "  -o file : write to file (mode 0600) instead of "
+        "standard output\n");
+    fprintf(stderr, "  --fsync[=MB] : sync the output to disk when done, "
+        "and every MB MiB\n");
+    fprintf(stderr, "  --mlock : fail unless phrase memory can be locked "
+        "into RAM\n");
+    fprintf(stderr, "  -b bufsize : read entropy in blocks of bufsize "
+        "bytes (default %d)\n", ENTROPY_BUFSIZE);
+    fprintf(stderr, "  --stats : report counters on stderr when done\n");
+    fprintf(stderr, "  --prefetch[=n] : fill n entropy blocks ahead on a "
+        "thread of their own\n"
+        "                   (default %d)\n", PREFETCH_DEPTH);
+    fprintf(stderr, "  --csprng[=MB] : expand a 256-bit seed with ChaCha20,"
+        " reseeding every MB MiB\n");
+    fprintf(stderr, "  --kernel name : assemble phrases with avx2, ssse3, "
+        "neon or scalar,\n"
+        "                  or in constant time with ct-avx2 or ct\n");
+    fprintf(stderr, "  --sampler name : draw word indices by auto (default), "
+        "multiply or mask\n");
+    fprintf(stderr, "  --format name : write phrases as raw lines (default), "
+        "nul-ended, jsonl\n"
+        "                 or tsv (number, word indices in hex, phrase)\n");
+    fprintf(stderr, "  --indices : with jsonl, list each phrase's word "
+        "indices\n");
+    fprintf(stderr, "  --max-len n : only phrases of at most n bytes, "
+        "drawn from all that fit\n");
+    fprintf(stderr, "  --digit : put a digit after one word\n");
+    fprintf(stderr, "  --symbol : put one of %s after one word\n",
+        "!#$%&*?@");
+    fprintf(stderr, "  --capitalize how : capitalize all words, the first "
+        "or none\n");
+    fprintf(stderr, "  --shard k/n : make part k of n of the count, "
+        "on keys of its own\n");
+    fprintf(stderr, "  --dedup[=MB] : drop repeated phrases with a MB MiB "
+        "filter (default %d)\n", DEDUP_MB);
+    fprintf(stderr, "  --seed hex : INSECURE, for tests: the same "
+        "phrases every run for a 256-bit seed\n");
+    fprintf(stderr, "  --insecure : allow --seed\n");
+    fprintf(stderr, "  --decode : print the bits encoded by each passphrase "
+        "read\n");
+    fprintf(stderr, "  --info : describe the word list and the entropy "
+        "per phrase\n");
+    fprintf(stderr, "  --backend : print the entropy backend in use\n");
+    fprintf(stderr, "  --selftest : check the vector kernels against "
+        "scalar\n");
+    fprintf(stderr, "  --serve socket : answer requests on a Unix socket "
+        "until signalled\n");
+    fprintf(stderr, "  --pool n : keep n phrases ready for --serve "
+        "(default %d)\n", SERVE_POOL);
+    fprintf(stderr, "  (default) : no delimiters, one passphrase\n");
+    exit(status);
+}
+
+
+enum { OPT_BACKEND = 256, OPT_CSPRNG, OPT_KERNEL, OPT_SELFTEST, OPT_STATS,
+    OPT_SERVE, OPT_POOL, OPT_INFO,
+    OPT_DECODE, OPT_SAMPLER, OPT_FORMAT, OPT_INDICES, OPT_FSYNC,
+    OPT_MLOCK, OPT_SEED, OPT_INSECURE, OPT_MAX_LEN, OPT_DIGIT, OPT_SYMBOL,
+    OPT_CAPITALIZE, OPT_SHARD, OPT_DEDUP, OPT_PREFETCH };
+
+static const struct option longopts[] = {
+    { "backend", no_argument,   NULL,   OPT_BACKEND },
+    { "csprng", optional_argument, NULL, OPT_CSPRNG },
+    { "kernel", required_argument, NULL, OPT_KERNEL },
+    { "selftest", no_argument,  NULL,   OPT_SELFTEST },
+    { "stats",  no_argument,    NULL,   OPT_STATS },
+    { "serve",  required_argument, NULL, OPT_SERVE },
+    { "pool",   required_argument, NULL, OPT_POOL },
+    { "info",   no_argument,    NULL,   OPT_INFO },
+    { "decode", no_argument,    NULL,   OPT_DECODE },
+    { "sampler", required_argument, NULL, OPT_SAMPLER },
+    { "format", required_argument, NULL, OPT_FORMAT },
+    { "indices", no_argument,   NULL,   OPT_INDICES },
+    { "fsync",  optional_argument, NULL, OPT_FSYNC },
+    { "mlock",  no_argument,    NULL,   OPT_MLOCK },
+    { "seed",   required_argument, NULL, OPT_SEED },
+    { "insecure", no_argument,  NULL,   OPT_INSECURE },
+    { "max-len", required_argument, NULL, OPT_MAX_LEN },
+    { "digit",  no_argument,    NULL,   OPT_DIGIT },
+    { "symbol", no_argument,    NULL,   OPT_SYMBOL },
+    { "capitalize", required_argument, NULL, OPT_CAPITALIZE },
+    { "shard",  required_argument, NULL, OPT_SHARD },
+    { "dedup",  optional_argument, NULL, OPT_DEDUP },
+    { "prefetch", optional_argument, NULL, OPT_PREFETCH },
+    { NULL,     0,              NULL,   0 }
 };
 
 
 int
 main(int argc, char *argv[]) {
-    unsigned int    randd;
+    mkpasswd_ctx        ctx;
+    mkpasswd_dict       *dict = NULL;
+    struct mkpasswd_stats   st;
+    struct mkpasswd_secure_stats    ms;
+    struct outbuf       out;
+    struct format       fmt = { FMT_RAW, 0, 0, "", 0, NULL, NULL, 0, NULL };
+    int                 sync = 0;
+    unsigned            shard = 0, nshards = 1;
+    unsigned long long  dedup_mb = 0, local;
+    unsigned            prefetch = 0;
+    unsigned long long  sync_every = 0;
+    struct timespec     t0, t1;
+    unsigned char       *ebuf;
+    const char          *kname = NULL, *sockpath = NULL, *dictpath = NULL;
+    const char          *sname = NULL, *outpath = NULL, *how;
+    unsigned long long  count = 1, need, reseed = 0;
+    size_t              bufsize = ENTROPY_BUFSIZE, pool = SERVE_POOL, size;
+    unsigned            nthr = 1, nwords = MKPASSWD_WORDS;
     char        sep = 0;
-    int     	ch, i, fd;
-    char        buf[sizeof(words[0])];
+    int     	ch, flags = 0, query_backend = 0, stats = 0, test = 0;
+    int         query_info = 0, decoding = 0, must_lock = 0, bulk;
+    int         seeded = 0, insecure = 0, policy = 0;
+    unsigned char   seed[32];
+    struct mkpasswd_policy_conf pc;
+    mkpasswd_policy     *pol = NULL;
 
 
-    while ((ch = getopt(argc, argv, "dhs")) != -1)
+    memset(&pc, 0, sizeof(pc));
+    while ((ch = getopt_long(argc, argv, "b:df:hj:n:o:sw:", longopts,
+        NULL)) != -1)
         switch(ch) {
+        case 'b':
+            bufsize = getnum(optarg, "buffer size",
+                ENTROPY_BUFSIZE_MIN, ENTROPY_BUFSIZE_MAX);
+            break;
+
         case 'd':
             sep = '-';
             break;
 
+        case 'f':
+            dictpath = optarg;
+            break;
+
+        case 'j':
+            nthr = getnum(optarg, "thread count", 1, MAX_THREADS);
+            break;
+
+        case 'n':
+            count = getnum(optarg, "count", 0, ~0ULL);
+            break;
+
+        case 'o':
+            outpath = optarg;
+            break;
+
         case 's':
             sep = ' ';
             break;
+
+        case 'w':
+            nwords = getnum(optarg, "word count", 1, MKPASSWD_MAX_WORDS);
+            break;
+
+        case OPT_BACKEND:
+            query_backend = 1;
+            break;
+
+        case OPT_CSPRNG:
+            flags |= MKPASSWD_CSPRNG;
+            if (optarg != NULL)
+                reseed = getnum(optarg, "reseed interval", 1,
+                    ~0ULL >> 20) << 20;
+            break;
+
+        case OPT_KERNEL:
+            kname = optarg;
+            break;
+
+        case OPT_SAMPLER:
+            sname = optarg;
+            break;
+
+        case OPT_FORMAT:
+            if (strcmp(optarg, "raw") == 0)
+                fmt.kind = FMT_RAW;
+            else if (strcmp(optarg, "nul") == 0)
+                fmt.kind = FMT_NUL;
+            else if (strcmp(optarg, "jsonl") == 0)
+                fmt.kind = FMT_JSONL;
+            else if (strcmp(optarg, "tsv") == 0)
+                fmt.kind = FMT_TSV;
+            else {
+                fprintf(stderr, "mkpasswd : format %s: unknown\n", optarg);
+                exit(EINVAL);
+            }
+            break;
+
+        case OPT_INDICES:
+            fmt.indices = 1;
+            break;
+
+        case OPT_FSYNC:
+            sync = 1;
+            if (optarg != NULL)
+                sync_every = getnum(optarg, "sync interval", 1,
+                    ~0ULL >> 20) << 20;
+            break;
+
+        case OPT_MLOCK:
+            must_lock = 1;
+            break;
+
+        case OPT_SEED:
+            getseed(optarg, seed);
+            seeded = 1;
+            break;
+
+        case OPT_INSECURE:
+            insecure = 1;
+            break;
+
+        case OPT_MAX_LEN:
+            pc.max_len = getnum(optarg, "length", 1, 65535);
+            policy = 1;
+            break;
+
+        case OPT_DIGIT:
+            pc.digit = 1;
+            policy = 1;
+            break;
+
+        case OPT_SYMBOL:
+            pc.symbol = 1;
+            policy = 1;
+            break;
+
+        case OPT_CAPITALIZE:
+            for (pc.capitalize = MKPASSWD_CAP_ALL;
+                pc.capitalize <= MKPASSWD_CAP_NONE &&
+                strcmp(optarg, caps[pc.capitalize]) != 0; pc.capitalize++)
+                ;
+            if (pc.capitalize > MKPASSWD_CAP_NONE) {
+                fprintf(stderr, "mkpasswd : --capitalize %s: not all, "
+                    "first or none\n", optarg);
+                exit(EINVAL);
+            }
+            policy = 1;
+            break;
+
+        case OPT_SHARD:
+            getshard(optarg, &shard, &nshards);
+            break;
+
+        case OPT_DEDUP:
+            dedup_mb = optarg != NULL ? getnum(optarg, "filter size", 1,
+                DEDUP_MB_MAX) : DEDUP_MB;
+            break;
+
+        case OPT_PREFETCH:
+            prefetch = optarg != NULL ? getnum(optarg, "prefetch depth", 1,
+                MKPASSWD_PREFETCH_MAX) : PREFETCH_DEPTH;
+            break;
+
+        case OPT_SELFTEST:
+            test = 1;
+            break;
+
+        case OPT_STATS:
+            stats = 1;
+            break;
+
+        case OPT_SERVE:
+            sockpath = optarg;
+            break;
+
+        case OPT_DECODE:
+            decoding = 1;
+            break;
+
+        case OPT_INFO:
+            query_info = 1;
+            break;
+
+        case OPT_POOL:
+            pool = getnum(optarg, "pool size", 1, SERVE_POOL_MAX);
+            break;
       
         case 'h':
-            fprintf(stderr, "usage: mkpasswd [-dsh]\n");
-            fprintf(stderr, "  -h : print this message\n");
-            fprintf(stderr, "  -d : delimit words with dashes\n");
-            fprintf(stderr, "  -s : delimit words with spaces\n");
-            fprintf(stderr, "  (default) : no delimiters\n");
-            exit(0);
-            break;
+            usage(0);
+        default:
+            usage(EINVAL);
+    }
+
+    if (fmt.indices && fmt.kind != FMT_JSONL) {
+        fprintf(stderr, "mkpasswd : --indices needs --format=jsonl\n");
+        exit(EINVAL);
+    }
+    if (seeded && !insecure) {
+        fprintf(stderr, "mkpasswd : --seed makes every phrase predictable "
+            "from the seed; it is for tests only, and needs --insecure\n");
+        exit(EINVAL);
     }
-          
-    fd = open(RANDDEV, O_RDONLY);
-    if (fd < 0) {
-        fprintf(stderr, "mkpasswd : unable to open " RANDDEV "\n");
-        exit(errno);
+    if (seeded && (sockpath != NULL || (flags & MKPASSWD_CSPRNG) ||
+        prefetch != 0)) {
+        fprintf(stderr, "mkpasswd : --seed is for bulk runs without "
+            "--csprng or --prefetch\n");
+        exit(EINVAL);
+    }
+    if (policy && (decoding || sockpath != NULL)) {
+        fprintf(stderr, "mkpasswd : --max-len, --digit, --symbol and "
+            "--capitalize are for bulk runs and --info\n");
+        exit(EINVAL);
+    }
+    if ((nshards > 1 || dedup_mb != 0) &&
+        (decoding || query_info || sockpath != NULL)) {
+        fprintf(stderr, "mkpasswd : --shard and --dedup are for bulk "
+            "runs\n");
+        exit(EINVAL);
+    }
+    if (seeded)
+        fprintf(stderr, "mkpasswd : warning: --seed: these passphrases are "
+            "NOT secret\n");
+    if (dictpath != NULL && (dict = mkpasswd_dict_open(dictpath)) == NULL) {
+        if (errno == EINVAL)
+            fprintf(stderr, "mkpasswd : %s: not a dictionary made by "
+                "mkdict\n", dictpath);
+        else
+            fail(dictpath);
+        exit(EINVAL);
     }
 
-    for (i=0; i<WORDS_PER_PHRASE; i++) {
-        read(fd, &randd, sizeof(randd));
-        randd %= sizeof(words)/sizeof(words[0]);
-        printf("%s", words[randd]);
-        if (sep != 0 && i < WORDS_PER_PHRASE-1)
-            printf("%c", sep);
-    } 
-    printf("\n");
-}
+    if (policy) {
+        pc.nwords = nwords;
+        pc.sep = sep;
+        if ((pol = mkpasswd_policy_create(dict, &pc)) == NULL) {
+            if (errno == EDOM) {
+                fprintf(stderr, "mkpasswd : --capitalize %s: %s may "
+                    "have words that differ only in case\n",
+                    caps[pc.capitalize], dictpath);
+                exit(EINVAL);
+            }
+            if (errno != ERANGE)
+                fail("unable to set up policy");
+            fprintf(stderr, "mkpasswd : --max-len %u: no phrase of %u "
+                "words is that short\n", pc.max_len, nwords);
+            exit(EINVAL);
+        }
+    }
+    if (query_info) {
+        info(dict, dictpath, nwords, sep, pol, &pc);
+        mkpasswd_policy_destroy(pol);
+        mkpasswd_dict_close(dict);
+        return 0;
+    }
+    if (decoding) {
+        struct mkpasswd_dict_info   di;
 
+        mkpasswd_dict_get_info(dict, &di);
+        if (!di.hashed) {
+            fprintf(stderr, "mkpasswd : %s: words differ only in case; "
+                "cannot decode\n", dictpath);
+            exit(ENOTSUP);
+        }
+        secure_setup(out_plan(&out, out_file(outpath),
+            2 * MKPASSWD_MAX_WORDS * sizeof(uint32_t) + 1, 0), must_lock);
+        out_alloc(&out);
+        out.sync = sync;
+        out.sync_every = sync_every;
+        ch = decode(dict, &out, nwords);
+        out_close(&out);
+        mkpasswd_dict_close(dict);
+        return ch;
+    }
+    if (!test && !query_backend && ambiguous(dict, sep, pc.capitalize))
+        fprintf(stderr, "mkpasswd : warning: %s: words run together "
+            "ambiguously; use -d or -s\n",
+            dictpath != NULL ? dictpath : "built-in");
+
+    /* don't read more than the whole run will consume */
+    local = shard_count(count, shard, nshards);
+    need = ceil(pol != NULL ? mkpasswd_policy_entropy_bits(pol) :
+        mkpasswd_dict_entropy_bits(dict, nwords));
+    if (!test && nthr == 1 && local < bufsize * 8 / need)
+        bufsize = (local * need + 7) / 8;
+    if (bufsize == 0)
+        bufsize = 1;
+    /*
+     *  Past a quarter or so of the phrases there are, or under 4
+     *  bits of filter a phrase, --dedup would draw on for longer
+     *  and longer.
+     */
+    if (dedup_mb != 0 && local > 0 && (log2(local) > need - 2 ||
+        local > (dedup_mb << 20) * 2)) {
+        fprintf(stderr, "mkpasswd : --dedup: too many phrases for %s\n",
+            log2(local) > need - 2 ? "the words" : "the filter; give it "
+            "more MiB");
+        exit(EINVAL);
+    }
+    /* the output is planned first, to size the arena for it all */
+    bulk = !test && !query_backend && sockpath == NULL;
+    if (bulk) {
+        /* a dictionary of long words may need more than one batch */
+        fmt.pol = pol;
+        format_init(&fmt, dict, nwords, sep);
+        size = secure_size(out_plan(&out, out_file(outpath),
+            format_room(&fmt, dict, local < BATCH ? local : BATCH, nwords),
+            local <= BATCH)) + secure_size(bufsize);
+        if (nthr > 1 && local > CHUNK)
+            size += (size_t)nthr * (secure_size(bufsize) +
+                2 * secure_size(format_room(&fmt, dict, CHUNK, nwords)) +
+                prefetch_size(prefetch, bufsize));
+        else
+            size += prefetch_size(prefetch, bufsize);
+        secure_setup(size, must_lock);
+    }
+    /*
+     *  Only a bulk run has an arena by now; the rest check names or
+     *  test with this context, and make do with its own buffer.
+     */
+    ebuf = bulk ? xsecure(bufsize) : NULL;
+    if (mkpasswd_init(&ctx, flags, ebuf, bufsize) != 0)
+        fail("unable to set up generator");
+    mkpasswd_set_dict(&ctx, dict);
+    mkpasswd_set_reseed(&ctx, reseed);
+    if (seeded)
+        mkpasswd_set_seed(&ctx, seed, 0);
+    else
+        mkpasswd_set_stream(&ctx, (unsigned long long)shard * MAX_THREADS);
+    /* the workers prefetch for themselves */
+    if (bulk && !(nthr > 1 && local > CHUNK) &&
+        mkpasswd_set_prefetch(&ctx, prefetch) != 0)
+        fail("unable to start prefetch");
+
+    if (query_backend) {
+        printf("%s\n", mkpasswd_backend_name(&ctx));
+        mkpasswd_destroy(&ctx);
+        return 0;
+    }
+    if (kname != NULL && mkpasswd_set_kernel(&ctx, kname) != 0) {
+        fprintf(stderr, "mkpasswd : kernel %s: %s\n", kname,
+            errno == ENOTSUP ? "not supported on this CPU" : "unknown");
+        exit(EINVAL);
+    }
+    /* a dictionary has a kernel of its own, which is not one */
+    if (kname != NULL && dict != NULL && strncmp(kname, "ct", 2) == 0) {
+        fprintf(stderr, "mkpasswd : kernel %s: needs the built-in word "
+            "list\n", kname);
+        exit(EINVAL);
+    }
+    if (kname != NULL && pol != NULL && strncmp(kname, "ct", 2) == 0) {
+        fprintf(stderr, "mkpasswd : kernel %s: not under a policy, whose "
+            "phrases have a kernel of their own\n", kname);
+        exit(EINVAL);
+    }
+    if (sname != NULL && mkpasswd_set_sampler(&ctx, sname) != 0) {
+        fprintf(stderr, "mkpasswd : sampler %s: unknown\n", sname);
+        exit(EINVAL);
+    }
+    if (sockpath != NULL) {
+        struct serve_conf   sc;
+
+        mkpasswd_destroy(&ctx);
+        mkpasswd_secure_free(ebuf, bufsize);
+        sc.path = sockpath;
+        sc.kernel = kname;
+        sc.dict = dict;
+        sc.nwords = nwords;
+        sc.sep = sep;
+        sc.flags = flags;
+        sc.reseed = reseed;
+        sc.pool = pool;
+        sc.stats = stats;
+        sc.mlock = must_lock;
+        sc.prefetch = prefetch;
+        if (serve(&sc) != 0)
+            fail(sockpath);
+        mkpasswd_dict_close(dict);
+        return 0;
+    }
+    if (test) {
+        ch = selftest(&ctx);
+        mkpasswd_destroy(&ctx);
+        mkpasswd_secure_free(ebuf, bufsize);
+        return ch;
+    }
+
+    out_alloc(&out);
+    out.sync = sync;
+    out.sync_every = sync_every;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    mkpasswd_get_stats(&ctx, &st);
+    if (dedup_mb != 0)
+        fmt.dedup = bloom_create(dedup_mb);
+    if (nthr > 1 && local > CHUNK)
+        generate_threaded(&ctx, dict, &out, &fmt, &st, flags, reseed, bufsize,
+            count, nwords, sep, nthr, seeded ? seed : NULL, shard, nshards,
+            prefetch);
+    else {
+        if (seeded || nshards > 1)
+            generate_chunks(&ctx, dict, &out, &fmt, count, nwords, sep,
+                seeded ? seed : NULL, shard, nshards);
+        else
+            generate(&ctx, dict, &out, &fmt, count, nwords, sep, 0);
+        mkpasswd_get_stats(&ctx, &st);
+    }
+    bloom_destroy(fmt.dedup);
+    how = out.spare != NULL ? "vmsplice" : "write";
+    out_close(&out);
+    mkpasswd_secure_get_stats(&ms);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (stats) {
+        fprintf(stderr, "backend=%s\n", mkpasswd_backend_name(&ctx));
+        fprintf(stderr, "kernel=%s\n", pol != NULL ? "policy" :
+            mkpasswd_current_kernel(&ctx));
+        fprintf(stderr, "sampler=%s\n", mkpasswd_current_sampler(&ctx));
+        fprintf(stderr, "threads=%u\n", nthr);
+        fprintf(stderr, "shard=%u/%u\n", shard + 1, nshards);
+        fprintf(stderr, "phrases=%llu\n", local);
+        fprintf(stderr, "dedup_drops=%llu\n", out.dups);
+        fprintf(stderr, "entropy_refills=%llu\n", st.refills);
+        fprintf(stderr, "entropy_bytes=%llu\n", st.entropy_bytes);
+        fprintf(stderr, "rng_syscalls=%llu\n", st.rng_syscalls);
+        fprintf(stderr, "rng_bytes=%llu\n", st.rng_bytes);
+        fprintf(stderr, "csprng=%d\n", (flags & MKPASSWD_CSPRNG) != 0);
+        fprintf(stderr, "csprng_seeds=%llu\n", st.seeds);
+        fprintf(stderr, "index_rejects=%llu\n", st.rejects);
+        fprintf(stderr, "prefetch_depth=%u\n", prefetch);
+        fprintf(stderr, "prefetch_stalls=%llu\n", st.prefetch_stalls);
+        fprintf(stderr, "output=%s\n", how);
+        fprintf(stderr, "write_calls=%llu\n", out.writes);
+        fprintf(stderr, "bytes_written=%llu\n", out.bytes);
+        fprintf(stderr, "arena_bytes=%zu\n", ms.size);
+        fprintf(stderr, "arena_locked=%d\n", ms.locked);
+        fprintf(stderr, "arena_fallbacks=%llu\n", ms.fallbacks);
+#ifdef MKPASSWD_TIMING
+        /* summed over threads */
+        fprintf(stderr, "entropy_ns=%llu\n", st.entropy_ns);
+        fprintf(stderr, "index_ns=%llu\n", st.index_ns);
+        fprintf(stderr, "assemble_ns=%llu\n", st.assemble_ns);
+        fprintf(stderr, "format_ns=%llu\n", out.format_ns);
+        fprintf(stderr, "write_ns=%llu\n", out.write_ns);
+#endif
+        fprintf(stderr, "first_byte_cpu_ns=%llu\n", first_byte_ns);
+        fprintf(stderr, "elapsed_ns=%lld\n",
+            (long long)(t1.tv_sec - t0.tv_sec) * 1000000000LL +
+            (t1.tv_nsec - t0.tv_nsec));
+    }
+    mkpasswd_destroy(&ctx);
+    mkpasswd_policy_destroy(pol);
+    mkpasswd_dict_close(dict);
+    mkpasswd_secure_free(ebuf, bufsize);
+    free(fmt.dec);
+    return 0;
+}
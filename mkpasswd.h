@@ -0,0 +1,371 @@
+/*
+ *    Copyright (c) 2013 Michael Sierchio
+ *    
+ *    All rights reserved.
+ *    
+ *    Redistribution and use in source and binary forms, with or
+ *    without modification, are permitted provided that the
+ *    following conditions are met:
+ *    
+ *    1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer.
+ *    
+ *    2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *    
+ *    THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS
+ *    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+ *    SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *    OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ *    THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ *    OF SUCH DAMAGE.
+ */
+
+
+/*
+ *  libmkpasswd:  the mkpasswd passphrase generator as a library
+ *
+ *          A context holds the entropy source and its buffer; all
+ *          output goes into caller-supplied memory and no call
+ *          allocates, pools, dictionaries, policies and secure
+ *          memory aside.
+ *          A context may be shared between threads (calls on it
+ *          are serialized by a spinlock), but one context per
+ *          thread is the way to scale.
+ *
+ *          Functions returning int or ssize_t return -1 and set
+ *          errno on failure.
+ */
+
+#ifndef MKPASSWD_H
+#define MKPASSWD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define	MKPASSWD_WORDS		6	/* default words per phrase */
+#define	MKPASSWD_MAX_WORDS	16
+#define	MKPASSWD_IBUFSIZE	4096	/* built-in entropy buffer */
+#define	MKPASSWD_PREFETCH_MAX	64	/* blocks mkpasswd_set_prefetch() keeps */
+
+/* mkpasswd_init() flags */
+#define	MKPASSWD_CSPRNG		0x01	/* expand a seed with ChaCha20 */
+
+struct mkpasswd_backend;
+struct mkpasswd_kernel;
+struct mkpasswd_prefetch;
+typedef struct mkpasswd_dict mkpasswd_dict;
+
+struct mkpasswd_stats {
+    unsigned long long  refills;        /* entropy buffer refills */
+    unsigned long long  entropy_bytes;  /* bytes put in the buffer */
+    unsigned long long  rng_syscalls;   /* system RNG calls */
+    unsigned long long  rng_bytes;      /* bytes from the system RNG */
+    unsigned long long  seeds;          /* CSPRNG (re)keyings */
+    unsigned long long  rejects;        /* index draws thrown away */
+    unsigned long long  prefetch_stalls;    /* refills that had to wait */
+    /* built with -DMKPASSWD_TIMING, else 0 */
+    unsigned long long  entropy_ns;     /* refilling the buffer */
+    unsigned long long  index_ns;       /* drawing indices, less refills */
+    unsigned long long  assemble_ns;    /* the kernel */
+};
+
+/*
+ *  The layout is public only so that a context can live on the
+ *  stack or in static storage; use the functions below.
+ */
+typedef struct mkpasswd_ctx {
+    int                             lock;
+    int                             flags;
+    int                             error;
+    int                             fd;
+    const struct mkpasswd_backend   *backend;
+    const struct mkpasswd_kernel    *kernel;
+    const struct mkpasswd_dict      *dict;
+    unsigned char                   *buf;
+    size_t                          size, pos, len;
+    uint64_t                        acc;
+    unsigned                        nbits;
+    unsigned                        sampler;
+    uint32_t                        key[8];
+    unsigned long long              reseed, since_seed;
+    unsigned long long              stream;
+    struct mkpasswd_prefetch        *prefetch;
+    struct mkpasswd_stats           stats;
+    unsigned char                   ibuf[MKPASSWD_IBUFSIZE];
+} mkpasswd_ctx;
+
+/*
+ *  Set up ctx.  Entropy is buffered in buf (bufsize bytes), or in
+ *  the context itself when buf is NULL, in which case bufsize may
+ *  cap how much of it is used (0 for all of it).
+ */
+int         mkpasswd_init(mkpasswd_ctx *ctx, int flags, void *buf,
+                size_t bufsize);
+void        mkpasswd_destroy(mkpasswd_ctx *ctx);
+
+/* rekey the CSPRNG from the system RNG every bytes of output */
+void        mkpasswd_set_reseed(mkpasswd_ctx *ctx, unsigned long long bytes);
+
+/*
+ *  With MKPASSWD_CSPRNG, derive every key from the system seed and
+ *  stream (below 2^32), so that contexts given different streams,
+ *  on one host or many, cannot share a keystream even if their
+ *  seeds collide, as on a cloned virtual machine.  Set it before
+ *  the first draw; it does not change the system RNG's output.
+ */
+void        mkpasswd_set_stream(mkpasswd_ctx *ctx, unsigned long long stream);
+
+/*
+ *  Fill the entropy buffer ahead: a thread of ctx's own keeps up to
+ *  depth (1 to MKPASSWD_PREFETCH_MAX) blocks of its size filled
+ *  from the system RNG, or expanded by the CSPRNG, and each refill
+ *  swaps the spent buffer for one, waiting only if none is ready
+ *  (counted in prefetch_stalls).  0 stops it.  Call it after the
+ *  other settings, which the thread copies; mkpasswd_set_seed()
+ *  stops it, as a seeded stream is cheaper to expand in place.
+ */
+int         mkpasswd_set_prefetch(mkpasswd_ctx *ctx, unsigned depth);
+
+/*
+ *  INSECURE, for tests and load generation: from here on ctx draws
+ *  on the ChaCha20 keystream of key, from block stream * 2^32 on,
+ *  instead of the system RNG, and whoever has the key has every
+ *  phrase.  Anything buffered is dropped, so a run made stream by
+ *  stream comes out the same however the streams are shared out
+ *  among contexts, kernels or buffer sizes.
+ */
+void        mkpasswd_set_seed(mkpasswd_ctx *ctx, const unsigned char key[32],
+                unsigned long long stream);
+
+/*
+ *  One NUL-terminated passphrase of nwords words joined by sep
+ *  (0 for none).  Returns its length.
+ */
+ssize_t     mkpasswd_generate(mkpasswd_ctx *ctx, char *out, size_t outlen,
+                unsigned nwords, char sep);
+
+/*
+ *  count passphrases, each ended by a newline and not terminated.
+ *  outlen must be at least mkpasswd_batch_size(count, nwords)
+ *  (mkpasswd_dict_batch_size() with a dictionary file); the
+ *  text is shorter, and bytes past it may be scribbled on.
+ *  Returns the length of the text.
+ */
+ssize_t     mkpasswd_generate_batch(mkpasswd_ctx *ctx, char *out,
+                size_t outlen, size_t count, unsigned nwords, char sep);
+size_t      mkpasswd_batch_size(size_t count, unsigned nwords);
+
+/* the same, also storing the count * nwords word indices at idx */
+ssize_t     mkpasswd_generate_batch_idx(mkpasswd_ctx *ctx, char *out,
+                size_t outlen, size_t count, unsigned nwords, char sep,
+                uint32_t *idx);
+
+/* bits of entropy in a phrase of nwords words */
+double      mkpasswd_entropy_bits(unsigned nwords);
+
+/*
+ *  Word lists other than the built-in one come from dictionary
+ *  files made by mkdict, which are mapped rather than read; a
+ *  dictionary must outlive every context set to use it.  NULL
+ *  stands for the built-in list throughout.  Phrases from a file
+ *  are assembled by a kernel of their own ("dict"), whatever
+ *  mkpasswd_set_kernel() says.
+ */
+mkpasswd_dict   *mkpasswd_dict_open(const char *path);
+void        mkpasswd_dict_close(mkpasswd_dict *dict);
+void        mkpasswd_set_dict(mkpasswd_ctx *ctx, const mkpasswd_dict *dict);
+size_t      mkpasswd_dict_words(const mkpasswd_dict *dict);
+
+/*
+ *  Facts about a word list, worked out when it was built.  A list
+ *  is decodable if phrases run together without a separator can
+ *  be split into words only one way; if not, such phrases carry
+ *  less than the nominal entropy.
+ */
+struct mkpasswd_dict_info {
+    size_t      words;
+    unsigned    minlen, maxlen;         /* bytes */
+    double      bits;                   /* per word */
+    int         unique;
+    int         decodable;              /* as printed */
+    int         decodable_nocase;       /* even with case ignored */
+    int         hashed;                 /* mkpasswd_decode() works */
+};
+
+void        mkpasswd_dict_get_info(const mkpasswd_dict *dict,
+                struct mkpasswd_dict_info *info);
+
+/*
+ *  Turn a passphrase back into word indices.  Case is ignored;
+ *  words may be separated by any run of spaces and punctuation,
+ *  or run together, in which case capitals are taken as word
+ *  starts if they fit and otherwise every split is tried, longest
+ *  words first.  Returns the number of words, or -1 with EINVAL
+ *  if the text does not split into words, ERANGE if it has more
+ *  than maxwords, or ENOTSUP if the dictionary has no hash.
+ */
+ssize_t     mkpasswd_decode(const mkpasswd_dict *dict, const char *phrase,
+                size_t len, uint32_t *idx, size_t maxwords);
+size_t      mkpasswd_dict_batch_size(const mkpasswd_dict *dict, size_t count,
+                unsigned nwords);
+double      mkpasswd_dict_entropy_bits(const mkpasswd_dict *dict,
+                unsigned nwords);
+
+/*
+ *  Policies, for systems that insist on a shape of password.  All
+ *  are met by construction, never by throwing phrases away: under
+ *  max_len the phrase is drawn uniformly from those that fit, from
+ *  a table of how many there are of each length; digit and symbol
+ *  append a digit, or one of "!#$%&*?@", to a word chosen at
+ *  random; capitalize sets the case of each word's first letter.
+ *  A policy is made for one word list, word count and separator,
+ *  holds no state, and may be shared between threads and contexts.
+ *  mkpasswd_policy_create() fails with ERANGE if no phrase fits
+ *  max_len, and with EDOM if capitalize is not asis on a list
+ *  without the hash, whose words may differ only in case.
+ *  mkpasswd_generate_policy() is mkpasswd_generate_batch_idx()
+ *  under a policy, on a context set to its list; its output needs
+ *  mkpasswd_policy_batch_size() bytes.  A digit or symbol keeps a
+ *  phrase from decoding.
+ */
+#define	MKPASSWD_CAP_ASIS	0	/* as the list has it */
+#define	MKPASSWD_CAP_ALL	1	/* every word */
+#define	MKPASSWD_CAP_FIRST	2	/* the first word only */
+#define	MKPASSWD_CAP_NONE	3
+
+typedef struct mkpasswd_policy mkpasswd_policy;
+
+struct mkpasswd_policy_conf {
+    unsigned    nwords;
+    char        sep;
+    unsigned    max_len;        /* bytes, 0 for no limit */
+    int         digit;          /* insert a digit */
+    int         symbol;         /* insert a symbol */
+    int         capitalize;     /* MKPASSWD_CAP_* */
+};
+
+mkpasswd_policy *mkpasswd_policy_create(const mkpasswd_dict *dict,
+                const struct mkpasswd_policy_conf *conf);
+void        mkpasswd_policy_destroy(mkpasswd_policy *pol);
+double      mkpasswd_policy_entropy_bits(const mkpasswd_policy *pol);
+size_t      mkpasswd_policy_batch_size(const mkpasswd_policy *pol,
+                size_t count);
+ssize_t     mkpasswd_generate_policy(mkpasswd_ctx *ctx,
+                const mkpasswd_policy *pol, char *out, size_t outlen,
+                size_t count, uint32_t *idx);
+
+/*
+ *  Secure memory for buffers that hold passphrases or entropy.
+ *  mkpasswd_secure_init() maps, once, an arena of size bytes,
+ *  locked into RAM with mlock(2) and left out of core dumps; it
+ *  returns 0, or 1 if the memory could not be locked (see
+ *  RLIMIT_MEMLOCK), or -1.  mkpasswd_secure_alloc() returns zeroed,
+ *  page-aligned memory from the arena, or from the heap once the
+ *  arena is used up or if there is none, and mkpasswd_secure_free()
+ *  wipes it and gives it back; n is the size asked for.  Pools
+ *  take their memory from here.  mkpasswd_secure_wipe() clears
+ *  memory in a way the compiler cannot drop.
+ */
+struct mkpasswd_secure_stats {
+    size_t              size, used;     /* bytes of arena */
+    int                 locked;
+    unsigned long long  fallbacks;      /* allocations from the heap */
+};
+
+int         mkpasswd_secure_init(size_t size);
+void        *mkpasswd_secure_alloc(size_t n);
+void        mkpasswd_secure_free(void *p, size_t n);
+void        mkpasswd_secure_wipe(void *p, size_t n);
+void        mkpasswd_secure_get_stats(struct mkpasswd_secure_stats *st);
+
+/*
+ *  Entropy backend and assembly kernel in use.  Phrase assembly
+ *  kernels are listed by mkpasswd_kernel_name(0, 1, ...) until it
+ *  returns NULL; mkpasswd_set_kernel() picks one by name (ENOENT if
+ *  unknown, ENOTSUP if this CPU lacks it).
+ */
+const char  *mkpasswd_backend_name(mkpasswd_ctx *ctx);
+const char  *mkpasswd_kernel_name(size_t i);
+const char  *mkpasswd_current_kernel(const mkpasswd_ctx *ctx);
+int         mkpasswd_set_kernel(mkpasswd_ctx *ctx, const char *name);
+
+/*
+ *  How word indices are drawn: "mask", with just enough bits and
+ *  a retry when out of range, or "multiply", by multiply-shift
+ *  with the width a dictionary was built for, which can take
+ *  fewer bits per word.  Both are uniform; "auto" (the default)
+ *  takes whichever is cheaper for the list.  ENOENT if unknown.
+ */
+const char  *mkpasswd_current_sampler(const mkpasswd_ctx *ctx);
+int         mkpasswd_set_sampler(mkpasswd_ctx *ctx, const char *name);
+
+/*
+ *  Compare the named kernel byte for byte against the scalar one on
+ *  random indices from ctx, for every word count and separator.
+ *  Returns 0 if they agree and 1 if not.
+ */
+int         mkpasswd_check_kernel(mkpasswd_ctx *ctx, const char *name);
+
+void        mkpasswd_get_stats(const mkpasswd_ctx *ctx,
+                struct mkpasswd_stats *st);
+
+/*
+ *  A pool holds up to high ready-made passphrases, which a thread
+ *  of its own tops up whenever no more than low remain, so that
+ *  taking one costs a copy.  Any number of threads may take from
+ *  one pool.  Each slot is wiped as it is taken; when the pool is
+ *  empty the phrase is generated on the spot and counted as a
+ *  stall.  high defaults to 4096 and low to high / 2.
+ */
+typedef struct mkpasswd_pool mkpasswd_pool;
+
+struct mkpasswd_pool_conf {
+    int                 flags;          /* as for mkpasswd_init() */
+    unsigned long long  reseed;         /* as for mkpasswd_set_reseed() */
+    const char          *kernel;        /* NULL for the default */
+    const mkpasswd_dict *dict;          /* NULL for the built-in list */
+    unsigned            nwords;
+    char                sep;
+    size_t              high, low;      /* watermarks */
+    unsigned            prefetch;       /* mkpasswd_set_prefetch() depth */
+};
+
+struct mkpasswd_pool_stats {
+    unsigned long long  hits;           /* taken ready-made */
+    unsigned long long  stalls;         /* generated on the spot */
+    unsigned long long  produced;       /* put in by the refill thread */
+    unsigned long long  wakeups;        /* refill thread woken at low */
+    size_t              level;          /* ready now */
+    unsigned long long  prefetch_stalls;    /* the refill thread's */
+    int                 error;          /* errno that stopped refills */
+};
+
+mkpasswd_pool   *mkpasswd_pool_create(const struct mkpasswd_pool_conf *conf);
+void        mkpasswd_pool_destroy(mkpasswd_pool *pool);
+
+/* one NUL-terminated passphrase, as for mkpasswd_generate() */
+ssize_t     mkpasswd_pool_get(mkpasswd_pool *pool, char *out, size_t outlen);
+void        mkpasswd_pool_get_stats(mkpasswd_pool *pool,
+                struct mkpasswd_pool_stats *st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MKPASSWD_H */
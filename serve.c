@@ -0,0 +1,509 @@
+/*
+ *    Copyright (c) 2013 Michael Sierchio
+ *    
+ *    All rights reserved.
+ *    
+ *    Redistribution and use in source and binary forms, with or
+ *    without modification, are permitted provided that the
+ *    following conditions are met:
+ *    
+ *    1. Redistributions of source code must retain the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer.
+ *    
+ *    2. Redistributions in binary form must reproduce the above
+ *    copyright notice, this list of conditions and the following
+ *    disclaimer in the documentation and/or other materials
+ *    provided with the distribution.
+ *    
+ *    THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS "AS
+ *    IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *    LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *    FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT
+ *    SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ *    INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ *    DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ *    SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *    OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ *    THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ *    OF SUCH DAMAGE.
+ */
+
+
+/*
+ *  serve.c:  mkpasswd --serve
+ *
+ *          Keeps the dictionary and a seeded generator warm and
+ *          hands out passphrases over a Unix stream socket.  Each
+ *          request is one line holding a count (empty means 1);
+ *          the reply is that many phrases, one per line, or "ERR"
+ *          and a reason.  Requests may be pipelined: everything
+ *          that has arrived is answered with a single write.
+ *
+ *          Phrases come out of a libmkpasswd pool that a background
+ *          thread keeps full, so a request costs a copy rather than
+ *          a trip through the generator.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#define	USE_EPOLL
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || \
+    defined(__NetBSD__) || defined(__DragonFly__)
+#include <sys/event.h>
+#define	USE_KQUEUE
+#else
+#error "--serve needs epoll or kqueue"
+#endif
+
+#include "serve.h"
+
+
+#define	MAX_REQUEST	4096		/* phrases per request */
+#define	LINE_MAX_REQ	64		/* longest request line */
+#define	INBUF_SIZE	4096
+#define	OUT_HIGH	(256 * 1024)	/* stop reading above this */
+#define	MAX_EVENTS	64
+#define	ARENA_CONNS	8		/* connections the arena is sized for */
+
+
+struct conn {
+    int     fd;
+    int     listener;
+    int     reading, writing;
+    char    in[INBUF_SIZE];
+    size_t  inlen;
+    char    *out;
+    size_t  outsize, outlen, outoff;
+};
+
+struct server {
+    const struct serve_conf *conf;
+    mkpasswd_pool           *pool;
+    int                     evfd;
+    unsigned long long      requests, phrases, errors, conns;
+};
+
+static volatile sig_atomic_t    stopping;
+
+static void
+on_signal(int sig) {
+    (void)sig;
+    stopping = 1;
+}
+
+
+/*
+ *  Event loop glue: rd and wr say which of read and write
+ *  readiness c wants to hear about.
+ */
+static int
+ev_open(void) {
+#ifdef USE_EPOLL
+    return epoll_create1(EPOLL_CLOEXEC);
+#else
+    return kqueue();
+#endif
+}
+
+static int
+ev_set(struct server *sv, struct conn *c, int rd, int wr, int add) {
+#ifdef USE_EPOLL
+    struct epoll_event  ev;
+
+    ev.events = (rd ? EPOLLIN : 0) | (wr ? EPOLLOUT : 0);
+    ev.data.ptr = c;
+    if (epoll_ctl(sv->evfd, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, c->fd,
+        &ev) != 0)
+        return -1;
+#else
+    struct kevent       ch[2];
+
+    (void)add;
+    EV_SET(&ch[0], c->fd, EVFILT_READ, EV_ADD | (rd ? EV_ENABLE : EV_DISABLE),
+        0, 0, c);
+    EV_SET(&ch[1], c->fd, EVFILT_WRITE, EV_ADD | (wr ? EV_ENABLE : EV_DISABLE),
+        0, 0, c);
+    if (kevent(sv->evfd, ch, 2, NULL, 0, NULL) != 0)
+        return -1;
+#endif
+    c->reading = rd;
+    c->writing = wr;
+    return 0;
+}
+
+struct evt {
+    struct conn *c;
+    int         rd, wr;
+};
+
+static int
+ev_wait(struct server *sv, struct evt *out, int max) {
+    int     i, n;
+#ifdef USE_EPOLL
+    struct epoll_event  evs[MAX_EVENTS];
+
+    if ((n = epoll_wait(sv->evfd, evs, max, -1)) < 0)
+        return -1;
+    for (i = 0; i < n; i++) {
+        out[i].c = evs[i].data.ptr;
+        out[i].rd = (evs[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+        out[i].wr = (evs[i].events & EPOLLOUT) != 0;
+    }
+#else
+    struct kevent       evs[MAX_EVENTS];
+
+    if ((n = kevent(sv->evfd, NULL, 0, evs, max, NULL)) < 0)
+        return -1;
+    for (i = 0; i < n; i++) {
+        out[i].c = evs[i].udata;
+        out[i].rd = evs[i].filter == EVFILT_READ;
+        out[i].wr = evs[i].filter == EVFILT_WRITE;
+    }
+#endif
+    return n;
+}
+
+
+static void
+conn_close(struct server *sv, struct conn *c) {
+    (void)sv;
+    close(c->fd);
+    mkpasswd_secure_free(c->out, c->outsize);
+    free(c);
+}
+
+static int
+conn_reserve(struct conn *c, size_t n) {
+    size_t      size;
+    char        *p;
+
+    if (c->outsize - c->outlen >= n)
+        return 0;
+    for (size = c->outsize ? c->outsize : 4096; size - c->outlen < n; )
+        size *= 2;
+    if ((p = mkpasswd_secure_alloc(size)) == NULL)
+        return -1;
+    if (c->out != NULL) {
+        memcpy(p, c->out, c->outlen);
+        mkpasswd_secure_free(c->out, c->outsize);
+    }
+    c->out = p;
+    c->outsize = size;
+    return 0;
+}
+
+static int
+conn_puts(struct conn *c, const char *s) {
+    size_t      n = strlen(s);
+
+    if (conn_reserve(c, n) != 0)
+        return -1;
+    memcpy(c->out + c->outlen, s, n);
+    c->outlen += n;
+    return 0;
+}
+
+/*
+ *  Answer one request for n phrases.
+ */
+static int
+answer(struct server *sv, struct conn *c, size_t n) {
+    size_t      i, start = c->outlen;
+    ssize_t     len;
+
+    if (conn_reserve(c, mkpasswd_dict_batch_size(sv->conf->dict, n,
+        sv->conf->nwords)) != 0)
+        return -1;
+    for (i = 0; i < n; i++) {
+        len = mkpasswd_pool_get(sv->pool, c->out + c->outlen,
+            c->outsize - c->outlen);
+        if (len < 0) {
+            mkpasswd_secure_wipe(c->out + start, c->outlen - start);
+            c->outlen = start;
+            return conn_puts(c, "ERR entropy unavailable\n");
+        }
+        c->outlen += len;
+        c->out[c->outlen++] = '\n';
+    }
+    sv->phrases += n;
+    return 0;
+}
+
+/*
+ *  Answer every complete line in c->in, stopping early if the
+ *  client is not keeping up with the replies.
+ */
+static int
+conn_process(struct server *sv, struct conn *c) {
+    char        *line = c->in, *nl, *ep;
+    unsigned long   n;
+    int         r;
+
+    while (c->outlen - c->outoff < OUT_HIGH &&
+        (nl = memchr(line, '\n', c->in + c->inlen - line)) != NULL) {
+        *nl = '\0';
+        if (nl > line && nl[-1] == '\r')
+            nl[-1] = '\0';
+        sv->requests++;
+        if (*line == '\0')
+            r = answer(sv, c, 1);
+        else {
+            errno = 0;
+            n = strtoul(line, &ep, 10);
+            if (errno != 0 || *ep != '\0' || *line == '-' || n < 1 ||
+                n > MAX_REQUEST) {
+                sv->errors++;
+                r = conn_puts(c, "ERR bad request\n");
+            } else
+                r = answer(sv, c, n);
+        }
+        if (r != 0)
+            return -1;
+        line = nl + 1;
+    }
+    c->inlen -= line - c->in;
+    memmove(c->in, line, c->inlen);
+    if (c->inlen == sizeof(c->in))
+        return -1;              /* no newline in a full buffer */
+    return 0;
+}
+
+static int
+conn_flush(struct conn *c) {
+    ssize_t     r;
+
+    while (c->outoff < c->outlen) {
+        r = send(c->fd, c->out + c->outoff, c->outlen - c->outoff,
+#ifdef MSG_NOSIGNAL
+            MSG_NOSIGNAL
+#else
+            0
+#endif
+            );
+        if (r < 0 && errno == EINTR)
+            continue;
+        if (r < 0)
+            return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+        c->outoff += r;
+    }
+    mkpasswd_secure_wipe(c->out, c->outlen);
+    c->outoff = c->outlen = 0;
+    return 0;
+}
+
+/*
+ *  Read what the client has sent, answer it, and write back as
+ *  much as the socket takes.  Returns -1 to drop the connection.
+ */
+static int
+conn_service(struct server *sv, struct conn *c, int rd) {
+    ssize_t     r;
+    int         eof = 0;
+
+    if (rd && c->reading) {
+        r = read(c->fd, c->in + c->inlen, sizeof(c->in) - c->inlen);
+        if (r == 0)
+            eof = 1;
+        else if (r < 0 && errno != EAGAIN && errno != EINTR)
+            return -1;
+        else if (r > 0)
+            c->inlen += r;
+    }
+    for (;;) {
+        if (conn_process(sv, c) != 0 || conn_flush(c) != 0)
+            return -1;
+        /* go round again if replies drained and requests remain */
+        if (c->outlen != 0 || memchr(c->in, '\n', c->inlen) == NULL)
+            break;
+    }
+    if (eof && c->outlen == 0)
+        return -1;
+    return ev_set(sv, c, !eof && c->outlen - c->outoff < OUT_HIGH,
+        c->outlen != 0, 0);
+}
+
+static void
+accept_all(struct server *sv, struct conn *l) {
+    struct conn *c;
+    int         fd;
+
+    while ((fd = accept(l->fd, NULL, NULL)) >= 0) {
+        if (fcntl(fd, F_SETFL, O_NONBLOCK) != 0 ||
+            fcntl(fd, F_SETFD, FD_CLOEXEC) != 0 ||
+            (c = calloc(1, sizeof(*c))) == NULL) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        if (ev_set(sv, c, 1, 0, 1) != 0) {
+            conn_close(sv, c);
+            continue;
+        }
+        sv->conns++;
+    }
+}
+
+
+static int
+listen_on(const char *path) {
+    struct sockaddr_un  sun;
+    struct stat         sb;
+    mode_t              mask;
+    int                 fd;
+
+    memset(&sun, 0, sizeof(sun));
+    sun.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(sun.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(sun.sun_path, path);
+    /* a stale socket from an earlier run would make bind() fail */
+    if (lstat(path, &sb) == 0 && S_ISSOCK(sb.st_mode))
+        unlink(path);
+    if ((fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0)
+        return -1;
+    /* passphrases are secrets: owner only */
+    mask = umask(077);
+    if (bind(fd, (struct sockaddr *)&sun, sizeof(sun)) != 0) {
+        umask(mask);
+        close(fd);
+        return -1;
+    }
+    umask(mask);
+    if (listen(fd, SOMAXCONN) != 0 || fcntl(fd, F_SETFL, O_NONBLOCK) != 0 ||
+        fcntl(fd, F_SETFD, FD_CLOEXEC) != 0) {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+    return fd;
+}
+
+/*
+ *  The pool, its prefetch ring and the reply buffers of a few busy
+ *  connections; more than that comes from the heap.
+ */
+static size_t
+arena_size(const struct serve_conf *cf) {
+    size_t      cap, req;
+
+    for (cap = 1; cap < cf->pool; cap <<= 1)
+        ;
+    req = mkpasswd_dict_batch_size(cf->dict, MAX_REQUEST, cf->nwords);
+    return cap * (mkpasswd_dict_batch_size(cf->dict, 1, cf->nwords) + 64) +
+        2 * req + ARENA_CONNS * (OUT_HIGH + 2 * req) +
+        (cf->prefetch != 0 ? (cf->prefetch + 2) * MKPASSWD_IBUFSIZE : 0);
+}
+
+int
+serve(const struct serve_conf *cf) {
+    static struct server    sv;
+    struct mkpasswd_pool_conf   pc;
+    struct mkpasswd_pool_stats  ps;
+    struct mkpasswd_secure_stats    ms;
+    struct evt          evs[MAX_EVENTS];
+    struct conn         lconn;
+    struct sigaction    sa;
+    int                 i, n;
+
+    sv.conf = cf;
+    memset(&pc, 0, sizeof(pc));
+    pc.flags = cf->flags;
+    pc.reseed = cf->reseed;
+    pc.kernel = cf->kernel;
+    pc.dict = cf->dict;
+    pc.nwords = cf->nwords;
+    pc.sep = cf->sep;
+    pc.high = cf->pool;
+    pc.low = cf->pool / 2;
+    pc.prefetch = cf->prefetch;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &sa, NULL);
+
+    if ((i = mkpasswd_secure_init(arena_size(cf))) < 0 ||
+        (i > 0 && cf->mlock))
+        return -1;
+
+    memset(&lconn, 0, sizeof(lconn));
+    lconn.listener = 1;
+    if ((lconn.fd = listen_on(cf->path)) < 0)
+        return -1;
+    if ((sv.evfd = ev_open()) < 0 || ev_set(&sv, &lconn, 1, 0, 1) != 0 ||
+        (sv.pool = mkpasswd_pool_create(&pc)) == NULL) {
+        n = errno;
+        if (sv.evfd >= 0)
+            close(sv.evfd);
+        close(lconn.fd);
+        unlink(cf->path);
+        errno = n;
+        return -1;
+    }
+
+    while (!stopping) {
+        if ((n = ev_wait(&sv, evs, MAX_EVENTS)) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        for (i = 0; i < n; i++) {
+            if (evs[i].c == NULL)
+                continue;
+            if (evs[i].c->listener)
+                accept_all(&sv, evs[i].c);
+            else if (conn_service(&sv, evs[i].c, evs[i].rd) != 0) {
+                conn_close(&sv, evs[i].c);
+                /* drop later events for the same connection */
+                for (int j = i + 1; j < n; j++)
+                    if (evs[j].c == evs[i].c)
+                        evs[j].c = NULL;
+            }
+        }
+    }
+
+    n = stopping ? 0 : errno;
+    mkpasswd_pool_get_stats(sv.pool, &ps);
+    mkpasswd_pool_destroy(sv.pool);
+    mkpasswd_secure_get_stats(&ms);
+    close(sv.evfd);
+    close(lconn.fd);
+    unlink(cf->path);
+    if (cf->stats) {
+        fprintf(stderr, "connections=%llu\n", sv.conns);
+        fprintf(stderr, "requests=%llu\n", sv.requests);
+        fprintf(stderr, "bad_requests=%llu\n", sv.errors);
+        fprintf(stderr, "phrases=%llu\n", sv.phrases);
+        fprintf(stderr, "pool_hits=%llu\n", ps.hits);
+        fprintf(stderr, "pool_stalls=%llu\n", ps.stalls);
+        fprintf(stderr, "pool_refill_wakeups=%llu\n", ps.wakeups);
+        fprintf(stderr, "prefetch_stalls=%llu\n", ps.prefetch_stalls);
+        fprintf(stderr, "arena_bytes=%zu\n", ms.size);
+        fprintf(stderr, "arena_locked=%d\n", ms.locked);
+        fprintf(stderr, "arena_fallbacks=%llu\n", ms.fallbacks);
+    }
+    if (n != 0) {
+        errno = n;
+        return -1;
+    }
+    return 0;
+}
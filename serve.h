@@ -0,0 +1,29 @@
+/*
+ *  serve.h:  mkpasswd --serve, passphrases over a Unix socket
+ */
+
+#ifndef SERVE_H
+#define SERVE_H
+
+#include "mkpasswd.h"
+
+#define	SERVE_POOL	4096		/* default phrases kept ready */
+#define	SERVE_POOL_MAX	(1 << 20)
+
+struct serve_conf {
+    const char          *path;          /* socket to listen on */
+    const char          *kernel;        /* NULL for the default */
+    const mkpasswd_dict *dict;          /* NULL for the built-in list */
+    unsigned            nwords;
+    char                sep;
+    int                 flags;          /* mkpasswd_init() flags */
+    unsigned long long  reseed;
+    size_t              pool;           /* pre-generated phrases */
+    int                 stats;          /* report on exit */
+    int                 mlock;          /* fail if memory can't be locked */
+    unsigned            prefetch;       /* entropy blocks filled ahead */
+};
+
+int     serve(const struct serve_conf *);
+
+#endif /* SERVE_H */
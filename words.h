@@ -0,0 +1,858 @@
+/*
+ *  Generated by mkdict -c from words.txt; do not edit.  The
+ *  built-in list of 2048 words, with the perfect hash of it
+ *  case folded (see dict.h).
+ */
+
+#define	NWORDS_BITS	11
+
+static const char words[1 << NWORDS_BITS][4] __attribute__((aligned(64))) = {
+    "Abe",  "Abed", "Abel", "Abet", "Able", "Abut", "Ace",  "Ache",
+    "Acid", "Acme", "Acre", "Act",  "Acta", "Acts", "Ada",  "Adam",
+    "Add",  "Adds", "Aden", "Afar", "Afro", "Age",  "Agee", "Ago",
+    "Ahem", "Ahoy", "Aid",  "Aida", "Aide", "Aids", "Aim",  "Air",
+    "Airy", "Ajar", "Akin", "Alan", "Alec", "Alga", "Alia", "All",
+    "Ally", "Alma", "Aloe", "Alp",  "Also", "Alto", "Alum", "Alva",
+    "Amen", "Ames", "Amid", "Ammo", "Amok", "Amos", "Amra", "Amy",
+    "Ana",  "And",  "Andy", "Anew", "Ann",  "Anna", "Anne", "Ant",
+    "Ante", "Anti", "Any",  "Ape",  "Aps",  "Apt",  "Aqua", "Arab",
+    "Arc",  "Arch", "Are",  "Area", "Argo", "Arid", "Ark",  "Arm",
+    "Army", "Art",  "Arts", "Arty", "Ash",  "Asia", "Ask",  "Asks",
+    "Ate",  "Atom", "Aug",  "Auk",  "Aunt", "Aura", "Auto", "Ave",
+    "Aver", "Avid", "Avis", "Avon", "Avow", "Away", "Awe",  "Awk",
+    "Awl",  "Awn",  "Awry", "Aye",  "Babe", "Baby", "Bach", "Back",
+    "Bad",  "Bade", "Bag",  "Bah",  "Bail", "Bait", "Bake", "Bald",
+    "Bale", "Bali", "Balk", "Ball", "Balm", "Bam",  "Ban",  "Band",
+    "Bane", "Bang", "Bank", "Bar",  "Barb", "Bard", "Bare", "Bark",
+    "Barn", "Barr", "Base", "Bash", "Bask", "Bass", "Bat",  "Bate",
+    "Bath", "Bawd", "Bawl", "Bay",  "Bead", "Beak", "Beam", "Bean",
+    "Bear", "Beat", "Beau", "Beck", "Bed",  "Bee",  "Beef", "Been",
+    "Beer", "Beet", "Beg",  "Bela", "Bell", "Belt", "Ben",  "Bend",
+    "Bent", "Berg", "Bern", "Bert", "Bess", "Best", "Bet",  "Beta",
+    "Beth", "Bey",  "Bhoy", "Bias", "Bib",  "Bid",  "Bide", "Bien",
+    "Big",  "Bile", "Bilk", "Bill", "Bin",  "Bind", "Bing", "Bird",
+    "Bit",  "Bite", "Bits", "Blab", "Blat", "Bled", "Blew", "Blob",
+    "Bloc", "Blot", "Blow", "Blue", "Blum", "Blur", "Boar", "Boat",
+    "Bob",  "Boca", "Bock", "Bode", "Body", "Bog",  "Bogy", "Bohr",
+    "Boil", "Bold", "Bolo", "Bolt", "Bomb", "Bon",  "Bona", "Bond",
+    "Bone", "Bong", "Bonn", "Bony", "Boo",  "Book", "Boom", "Boon",
+    "Boot", "Bop",  "Bore", "Borg", "Born", "Bose", "Boss", "Both",
+    "Bout", "Bow",  "Bowl", "Box",  "Boy",  "Boyd", "Brad", "Brae",
+    "Brag", "Bran", "Bray", "Bred", "Brew", "Brig", "Brim", "Brow",
+    "Bub",  "Buck", "Bud",  "Budd", "Buff", "Bug",  "Bulb", "Bulk",
+    "Bull", "Bum",  "Bun",  "Bunk", "Bunt", "Buoy", "Burg", "Burl",
+    "Burn", "Burr", "Burt", "Bury", "Bus",  "Bush", "Buss", "Bust",
+    "Busy", "But",  "Buy",  "Bye",  "Byte", "Cab",  "Cady", "Cafe",
+    "Cage", "Cain", "Cake", "Cal",  "Calf", "Call", "Calm", "Cam",
+    "Came", "Can",  "Cane", "Cant", "Cap",  "Car",  "Card", "Care",
+    "Carl", "Carr", "Cart", "Case", "Cash", "Cask", "Cast", "Cat",
+    "Cave", "Caw",  "Ceil", "Cell", "Cent", "Cern", "Chad", "Char",
+    "Chat", "Chaw", "Chef", "Chen", "Chew", "Chic", "Chin", "Chou",
+    "Chow", "Chub", "Chug", "Chum", "Cite", "City", "Clad", "Clam",
+    "Clan", "Claw", "Clay", "Clod", "Clog", "Clot", "Club", "Clue",
+    "Coal", "Coat", "Coca", "Cock", "Coco", "Cod",  "Coda", "Code",
+    "Cody", "Coed", "Cog",  "Coil", "Coin", "Coke", "Col",  "Cola",
+    "Cold", "Colt", "Coma", "Comb", "Come", "Con",  "Coo",  "Cook",
+    "Cool", "Coon", "Coot", "Cop",  "Cord", "Core", "Cork", "Corn",
+    "Cost", "Cot",  "Cove", "Cow",  "Cowl", "Coy",  "Crab", "Crag",
+    "Cram", "Cray", "Crew", "Crib", "Crow", "Crud", "Cry",  "Cub",
+    "Cuba", "Cube", "Cue",  "Cuff", "Cull", "Cult", "Cuny", "Cup",
+    "Cur",  "Curb", "Curd", "Cure", "Curl", "Curt", "Cut",  "Cuts",
+    "Dab",  "Dad",  "Dade", "Dale", "Dam",  "Dame", "Dan",  "Dana",
+    "Dane", "Dang", "Dank", "Dar",  "Dare", "Dark", "Darn", "Dart",
+    "Dash", "Data", "Date", "Dave", "Davy", "Dawn", "Day",  "Days",
+    "Dead", "Deaf", "Deal", "Dean", "Dear", "Debt", "Deck", "Dee",
+    "Deed", "Deem", "Deep", "Deer", "Deft", "Defy", "Del",  "Dell",
+    "Den",  "Dent", "Deny", "Des",  "Desk", "Dew",  "Dial", "Dice",
+    "Did",  "Die",  "Died", "Diet", "Dig",  "Dime", "Din",  "Dine",
+    "Ding", "Dint", "Dip",  "Dire", "Dirt", "Disc", "Dish", "Disk",
+    "Dive", "Dock", "Doe",  "Does", "Dog",  "Dole", "Doll", "Dolt",
+    "Dome", "Don",  "Done", "Doom", "Door", "Dora", "Dose", "Dot",
+    "Dote", "Doug", "Dour", "Dove", "Dow",  "Down", "Drab", "Drag",
+    "Dram", "Draw", "Drew", "Drop", "Drub", "Drug", "Drum", "Dry",
+    "Dual", "Dub",  "Duck", "Duct", "Dud",  "Due",  "Duel", "Duet",
+    "Dug",  "Duke", "Dull", "Dumb", "Dun",  "Dune", "Dunk", "Dusk",
+    "Dust", "Duty", "Each", "Ear",  "Earl", "Earn", "Ease", "East",
+    "Easy", "Eat",  "Eben", "Echo", "Eddy", "Eden", "Edge", "Edgy",
+    "Edit", "Edna", "Eel",  "Egan", "Egg",  "Ego",  "Elan", "Elba",
+    "Eli",  "Elk",  "Ella", "Elm",  "Else", "Ely",  "Emil", "Emit",
+    "Emma", "End",  "Ends", "Eric", "Eros", "Est",  "Etc",  "Eva",
+    "Eve",  "Even", "Ever", "Evil", "Ewe",  "Eye",  "Eyed", "Face",
+    "Fact", "Fad",  "Fade", "Fail", "Fain", "Fair", "Fake", "Fall",
+    "Fame", "Fan",  "Fang", "Far",  "Farm", "Fast", "Fat",  "Fate",
+    "Fawn", "Fay",  "Fear", "Feat", "Fed",  "Fee",  "Feed", "Feel",
+    "Feet", "Fell", "Felt", "Fend", "Fern", "Fest", "Feud", "Few",
+    "Fib",  "Fief", "Fig",  "Figs", "File", "Fill", "Film", "Fin",
+    "Find", "Fine", "Fink", "Fir",  "Fire", "Firm", "Fish", "Fisk",
+    "Fist", "Fit",  "Fits", "Five", "Fix",  "Flag", "Flak", "Flam",
+    "Flat", "Flaw", "Flea", "Fled", "Flew", "Flit", "Flo",  "Floc",
+    "Flog", "Flow", "Flub", "Flue", "Fly",  "Foal", "Foam", "Foe",
+    "Fog",  "Fogy", "Foil", "Fold", "Folk", "Fond", "Font", "Food",
+    "Fool", "Foot", "For",  "Ford", "Fore", "Fork", "Form", "Fort",
+    "Foss", "Foul", "Four", "Fowl", "Fox",  "Frau", "Fray", "Fred",
+    "Free", "Fret", "Frey", "Frog", "From", "Fry",  "Fuel", "Full",
+    "Fum",  "Fume", "Fun",  "Fund", "Funk", "Fur",  "Fury", "Fuse",
+    "Fuss", "Gab",  "Gad",  "Gaff", "Gag",  "Gage", "Gail", "Gain",
+    "Gait", "Gal",  "Gala", "Gale", "Gall", "Galt", "Gam",  "Game",
+    "Gang", "Gap",  "Garb", "Gary", "Gas",  "Gash", "Gate", "Gaul",
+    "Gaur", "Gave", "Gawk", "Gay",  "Gear", "Gee",  "Gel",  "Geld",
+    "Gem",  "Gene", "Gent", "Germ", "Get",  "Gets", "Gibe", "Gift",
+    "Gig",  "Gil",  "Gild", "Gill", "Gilt", "Gin",  "Gina", "Gird",
+    "Girl", "Gist", "Give", "Glad", "Glee", "Glen", "Glib", "Glob",
+    "Glom", "Glow", "Glue", "Glum", "Glut", "Goad", "Goal", "Goat",
+    "God",  "Goer", "Goes", "Gold", "Golf", "Gone", "Gong", "Good",
+    "Goof", "Gore", "Gory", "Gosh", "Got",  "Gout", "Gown", "Grab",
+    "Grad", "Gray", "Greg", "Grew", "Grey", "Grid", "Grim", "Grin",
+    "Grit", "Grow", "Grub", "Gulf", "Gull", "Gum",  "Gun",  "Gunk",
+    "Guru", "Gus",  "Gush", "Gust", "Gut",  "Guy",  "Gwen", "Gwyn",
+    "Gym",  "Gyp",  "Haag", "Haas", "Hack", "Had",  "Hail", "Hair",
+    "Hal",  "Hale", "Half", "Hall", "Halo", "Halt", "Ham",  "Han",
+    "Hand", "Hang", "Hank", "Hans", "Hap",  "Hard", "Hark", "Harm",
+    "Hart", "Has",  "Hash", "Hast", "Hat",  "Hate", "Hath", "Haul",
+    "Have", "Haw",  "Hawk", "Hay",  "Hays", "Head", "Heal", "Hear",
+    "Heat", "Hebe", "Heck", "Heed", "Heel", "Heft", "Held", "Hell",
+    "Helm", "Help", "Hem",  "Hen",  "Her",  "Herb", "Herd", "Here",
+    "Hero", "Hers", "Hess", "Hew",  "Hewn", "Hey",  "Hick", "Hid",
+    "Hide", "High", "Hike", "Hill", "Hilt", "Him",  "Hind", "Hint",
+    "Hip",  "Hire", "His",  "Hiss", "Hit",  "Hive", "Hob",  "Hobo",
+    "Hoc",  "Hock", "Hoe",  "Hoff", "Hog",  "Hold", "Hole", "Holm",
+    "Holt", "Home", "Hone", "Honk", "Hood", "Hoof", "Hook", "Hoot",
+    "Hop",  "Hope", "Horn", "Hose", "Host", "Hot",  "Hour", "Hove",
+    "How",  "Howe", "Howl", "Hoyt", "Hub",  "Huck", "Hue",  "Hued",
+    "Huff", "Hug",  "Huge", "Hugh", "Hugo", "Huh",  "Hulk", "Hull",
+    "Hum",  "Hunk", "Hunt", "Hurd", "Hurl", "Hurt", "Hush", "Hut",
+    "Hyde", "Hymn", "Ibis", "Ice",  "Icon", "Icy",  "Ida",  "Idea",
+    "Idle", "Iffy", "Ike",  "Ill",  "Inca", "Inch", "Ink",  "Inn",
+    "Into", "Ion",  "Ions", "Iota", "Iowa", "Ira",  "Ire",  "Iris",
+    "Irk",  "Irma", "Iron", "Isle", "Itch", "Item", "Its",  "Ivan",
+    "Ivy",  "Jab",  "Jack", "Jade", "Jag",  "Jail", "Jake", "Jam",
+    "Jan",  "Jane", "Jar",  "Java", "Jaw",  "Jay",  "Jean", "Jeff",
+    "Jerk", "Jess", "Jest", "Jet",  "Jibe", "Jig",  "Jill", "Jilt",
+    "Jim",  "Jive", "Joan", "Job",  "Jobs", "Jock", "Joe",  "Joel",
+    "Joey", "Jog",  "John", "Join", "Joke", "Jolt", "Jot",  "Jove",
+    "Joy",  "Judd", "Jude", "Judo", "Judy", "Jug",  "Juju", "Juke",
+    "July", "Jump", "June", "Junk", "Juno", "Jury", "Just", "Jut",
+    "Jute", "Kahn", "Kale", "Kane", "Kant", "Karl", "Kate", "Kay",
+    "Keel", "Keen", "Keep", "Keg",  "Ken",  "Keno", "Kent", "Kern",
+    "Kerr", "Key",  "Keys", "Kick", "Kid",  "Kill", "Kim",  "Kin",
+    "Kind", "King", "Kirk", "Kiss", "Kit",  "Kite", "Klan", "Knee",
+    "Knew", "Knit", "Knob", "Knot", "Know", "Koch", "Kong", "Kudo",
+    "Kurd", "Kurt", "Kyle", "Lab",  "Lac",  "Lace", "Lack", "Lacy",
+    "Lad",  "Lady", "Lag",  "Laid", "Lain", "Lair", "Lake", "Lam",
+    "Lamb", "Lame", "Lamp", "Land", "Lane", "Lang", "Lap",  "Lard",
+    "Lark", "Lass", "Last", "Late", "Laud", "Lava", "Law",  "Lawn",
+    "Laws", "Lay",  "Lays", "Lazy", "Lea",  "Lead", "Leaf", "Leak",
+    "Lean", "Lear", "Led",  "Lee",  "Leek", "Leer", "Left", "Leg",
+    "Len",  "Lend", "Lens", "Lent", "Leo",  "Leon", "Lesk", "Less",
+    "Lest", "Let",  "Lets", "Lew",  "Liar", "Lice", "Lick", "Lid",
+    "Lie",  "Lied", "Lien", "Lies", "Lieu", "Life", "Lift", "Like",
+    "Lila", "Lilt", "Lily", "Lima", "Limb", "Lime", "Lin",  "Lind",
+    "Line", "Link", "Lint", "Lion", "Lip",  "Lisa", "List", "Lit",
+    "Live", "Load", "Loaf", "Loam", "Loan", "Lob",  "Lock", "Loft",
+    "Log",  "Loge", "Lois", "Lola", "Lone", "Long", "Look", "Loon",
+    "Loot", "Lop",  "Lord", "Lore", "Los",  "Lose", "Loss", "Lost",
+    "Lot",  "Lou",  "Loud", "Love", "Low",  "Lowe", "Loy",  "Luck",
+    "Lucy", "Lug",  "Luge", "Luke", "Lulu", "Lund", "Lung", "Lura",
+    "Lure", "Lurk", "Lush", "Lust", "Lye",  "Lyle", "Lynn", "Lyon",
+    "Lyra", "Mac",  "Mace", "Mad",  "Made", "Mae",  "Magi", "Maid",
+    "Mail", "Main", "Make", "Male", "Mali", "Mall", "Malt", "Man",
+    "Mana", "Mann", "Many", "Mao",  "Map",  "Marc", "Mare", "Mark",
+    "Mars", "Mart", "Mary", "Mash", "Mask", "Mass", "Mast", "Mat",
+    "Mate", "Math", "Maul", "Maw",  "May",  "Mayo", "Mead", "Meal",
+    "Mean", "Meat", "Meek", "Meet", "Meg",  "Mel",  "Meld", "Melt",
+    "Memo", "Men",  "Mend", "Menu", "Mert", "Mesh", "Mess", "Met",
+    "Mew",  "Mice", "Mid",  "Mike", "Mild", "Mile", "Milk", "Mill",
+    "Milt", "Mimi", "Min",  "Mind", "Mine", "Mini", "Mink", "Mint",
+    "Mire", "Miss", "Mist", "Mit",  "Mite", "Mitt", "Mix",  "Moan",
+    "Moat", "Mob",  "Mock", "Mod",  "Mode", "Moe",  "Mold", "Mole",
+    "Moll", "Molt", "Mona", "Monk", "Mont", "Moo",  "Mood", "Moon",
+    "Moor", "Moot", "Mop",  "More", "Morn", "Mort", "Mos",  "Moss",
+    "Most", "Mot",  "Moth", "Move", "Mow",  "Much", "Muck", "Mud",
+    "Mudd", "Muff", "Mug",  "Mule", "Mull", "Mum",  "Murk", "Mush",
+    "Must", "Mute", "Mutt", "Myra", "Myth", "Nab",  "Nag",  "Nagy",
+    "Nail", "Nair", "Name", "Nan",  "Nap",  "Nary", "Nash", "Nat",
+    "Nave", "Navy", "Nay",  "Neal", "Near", "Neat", "Neck", "Ned",
+    "Nee",  "Need", "Neil", "Nell", "Neon", "Nero", "Ness", "Nest",
+    "Net",  "New",  "News", "Newt", "Next", "Nib",  "Nibs", "Nice",
+    "Nick", "Nil",  "Nile", "Nina", "Nine", "Nip",  "Nit",  "Noah",
+    "Nob",  "Nod",  "Node", "Noel", "Noll", "Non",  "None", "Nook",
+    "Noon", "Nor",  "Norm", "Nose", "Not",  "Note", "Noun", "Nov",
+    "Nova", "Now",  "Nude", "Null", "Numb", "Nun",  "Nut",  "Oaf",
+    "Oak",  "Oar",  "Oat",  "Oath", "Obey", "Oboe", "Odd",  "Ode",
+    "Odin", "Off",  "Oft",  "Ohio", "Oil",  "Oily", "Oint", "Okay",
+    "Olaf", "Old",  "Oldy", "Olga", "Olin", "Oman", "Omen", "Omit",
+    "Once", "One",  "Ones", "Only", "Onto", "Onus", "Open", "Oral",
+    "Orb",  "Ore",  "Orgy", "Orr",  "Oslo", "Otis", "Ott",  "Otto",
+    "Ouch", "Our",  "Oust", "Out",  "Outs", "Ova",  "Oval", "Oven",
+    "Over", "Owe",  "Owl",  "Owly", "Own",  "Owns", "Pad",  "Page",
+    "Pain", "Pair", "Pal",  "Pam",  "Pan",  "Pap",  "Par",  "Park",
+    "Part", "Pass", "Past", "Pat",  "Path", "Paw",  "Pay",  "Pea",
+    "Peg",  "Pen",  "Pep",  "Per",  "Pet",  "Pew",  "Phi",  "Pick",
+    "Pie",  "Pig",  "Pin",  "Pink", "Pit",  "Play", "Ply",  "Pod",
+    "Poe",  "Pool", "Poor", "Pop",  "Pot",  "Pour", "Pow",  "Pro",
+    "Pry",  "Pub",  "Pug",  "Pull", "Pun",  "Pup",  "Push", "Put",
+    "Quad", "Quit", "Quo",  "Quod", "Race", "Rack", "Racy", "Raft",
+    "Rag",  "Rage", "Raid", "Rail", "Rain", "Rake", "Ram",  "Ran",
+    "Rank", "Rant", "Rap",  "Rare", "Rash", "Rat",  "Rate", "Rave",
+    "Raw",  "Ray",  "Rays", "Read", "Real", "Ream", "Rear", "Reb",
+    "Reck", "Red",  "Reed", "Reef", "Reek", "Reel", "Reid", "Rein",
+    "Rena", "Rend", "Rent", "Rep",  "Rest", "Ret",  "Rib",  "Rice",
+    "Rich", "Rick", "Rid",  "Ride", "Rift", "Rig",  "Rill", "Rim",
+    "Rime", "Ring", "Rink", "Rio",  "Rip",  "Rise", "Risk", "Rite",
+    "Road", "Roam", "Roar", "Rob",  "Robe", "Rock", "Rod",  "Rode",
+    "Roe",  "Roil", "Roll", "Rome", "Ron",  "Rood", "Roof", "Rook",
+    "Room", "Root", "Rosa", "Rose", "Ross", "Rosy", "Rot",  "Roth",
+    "Rout", "Rove", "Row",  "Rowe", "Rows", "Roy",  "Rub",  "Rube",
+    "Ruby", "Rude", "Rudy", "Rue",  "Rug",  "Ruin", "Rule", "Rum",
+    "Run",  "Rung", "Runs", "Runt", "Ruse", "Rush", "Rusk", "Russ",
+    "Rust", "Ruth", "Rye",  "Sac",  "Sack", "Sad",  "Safe", "Sag",
+    "Sage", "Said", "Sail", "Sal",  "Sale", "Salk", "Salt", "Sam",
+    "Same", "San",  "Sand", "Sane", "Sang", "Sank", "Sap",  "Sara",
+    "Sat",  "Saul", "Save", "Saw",  "Say",  "Says", "Scan", "Scar",
+    "Scat", "Scot", "Sea",  "Seal", "Seam", "Sear", "Seat", "Sec",
+    "See",  "Seed", "Seek", "Seem", "Seen", "Sees", "Self", "Sell",
+    "Sen",  "Send", "Sent", "Set",  "Sets", "Sew",  "Sewn", "Sex",
+    "Shag", "Sham", "Shaw", "Shay", "She",  "Shed", "Shim", "Shin",
+    "Ship", "Shod", "Shoe", "Shop", "Shot", "Show", "Shun", "Shut",
+    "Shy",  "Sick", "Side", "Sift", "Sigh", "Sign", "Silk", "Sill",
+    "Silo", "Silt", "Sin",  "Sine", "Sing", "Sink", "Sip",  "Sir",
+    "Sire", "Sis",  "Sit",  "Site", "Sits", "Situ", "Six",  "Size",
+    "Skat", "Skew", "Ski",  "Skid", "Skim", "Skin", "Skit", "Sky",
+    "Slab", "Slam", "Slat", "Slay", "Sled", "Slew", "Slid", "Slim",
+    "Slip", "Slit", "Slob", "Slog", "Slot", "Slow", "Slug", "Slum",
+    "Slur", "Sly",  "Smog", "Smug", "Snag", "Snob", "Snow", "Snub",
+    "Snug", "Soak", "Soap", "Soar", "Sob",  "Sock", "Sod",  "Soda",
+    "Sofa", "Soft", "Soil", "Sold", "Some", "Son",  "Song", "Soon",
+    "Soot", "Sop",  "Sore", "Sort", "Soul", "Soup", "Sour", "Sow",
+    "Sown", "Soy",  "Spa",  "Spy",  "Stab", "Stag", "Stan", "Star",
+    "Stay", "Stem", "Step", "Stew", "Stir", "Stop", "Stow", "Stub",
+    "Stun", "Sub",  "Such", "Sud",  "Suds", "Sue",  "Suit", "Sulk",
+    "Sum",  "Sums", "Sun",  "Sung", "Sunk", "Sup",  "Sure", "Surf",
+    "Swab", "Swag", "Swam", "Swan", "Swat", "Sway", "Swim", "Swum",
+    "Tab",  "Tack", "Tact", "Tad",  "Tag",  "Tail", "Take", "Tale",
+    "Talk", "Tall", "Tan",  "Tank", "Tap",  "Tar",  "Task", "Tate",
+    "Taut", "Taxi", "Tea",  "Teal", "Team", "Tear", "Tech", "Ted",
+    "Tee",  "Teem", "Teen", "Teet", "Tell", "Ten",  "Tend", "Tent",
+    "Term", "Tern", "Tess", "Test", "Than", "That", "The",  "Thee",
+    "Them", "Then", "They", "Thin", "This", "Thud", "Thug", "Thy",
+    "Tic",  "Tick", "Tide", "Tidy", "Tie",  "Tied", "Tier", "Tile",
+    "Till", "Tilt", "Tim",  "Time", "Tin",  "Tina", "Tine", "Tint",
+    "Tiny", "Tip",  "Tire", "Toad", "Toe",  "Tog",  "Togo", "Toil",
+    "Told", "Toll", "Tom",  "Ton",  "Tone", "Tong", "Tony", "Too",
+    "Took", "Tool", "Toot", "Top",  "Tore", "Torn", "Tote", "Tour",
+    "Tout", "Tow",  "Town", "Toy",  "Trag", "Tram", "Tray", "Tree",
+    "Trek", "Trig", "Trim", "Trio", "Trod", "Trot", "Troy", "True",
+    "Try",  "Tub",  "Tuba", "Tube", "Tuck", "Tuft", "Tug",  "Tum",
+    "Tun",  "Tuna", "Tune", "Tung", "Turf", "Turn", "Tusk", "Twig",
+    "Twin", "Twit", "Two",  "Type", "Ugly", "Ulan", "Unit", "Urge",
+    "Use",  "Used", "User", "Uses", "Utah", "Vail", "Vain", "Vale",
+    "Van",  "Vary", "Vase", "Vast", "Vat",  "Veal", "Veda", "Veil",
+    "Vein", "Vend", "Vent", "Verb", "Very", "Vet",  "Veto", "Vice",
+    "Vie",  "View", "Vine", "Vise", "Void", "Volt", "Vote", "Wack",
+    "Wad",  "Wade", "Wag",  "Wage", "Wail", "Wait", "Wake", "Wale",
+    "Walk", "Wall", "Walt", "Wand", "Wane", "Wang", "Want", "War",
+    "Ward", "Warm", "Warn", "Wart", "Was",  "Wash", "Wast", "Wats",
+    "Watt", "Wave", "Wavy", "Way",  "Ways", "Weak", "Weal", "Wean",
+    "Wear", "Web",  "Wed",  "Wee",  "Weed", "Week", "Weir", "Weld",
+    "Well", "Welt", "Went", "Were", "Wert", "West", "Wet",  "Wham",
+    "What", "Whee", "When", "Whet", "Who",  "Whoa", "Whom", "Why",
+    "Wick", "Wide", "Wife", "Wild", "Will", "Win",  "Wind", "Wine",
+    "Wing", "Wink", "Wino", "Wire", "Wise", "Wish", "Wit",  "With",
+    "Wok",  "Wolf", "Won",  "Wont", "Woo",  "Wood", "Wool", "Word",
+    "Wore", "Work", "Worm", "Worn", "Wove", "Wow",  "Writ", "Wry",
+    "Wynn", "Yale", "Yam",  "Yang", "Yank", "Yap",  "Yard", "Yarn",
+    "Yaw",  "Yawl", "Yawn", "Yea",  "Yeah", "Year", "Yell", "Yes",
+    "Yet",  "Yoga", "Yoke", "You",  "Your", "Zap",  "Zero", "Zoo"
+};
+
+static const uint8_t wordlen4[256] __attribute__((aligned(64))) = {
+    0xbe, 0xb7, 0x5e, 0x3b, 0x7f, 0xf7, 0x7f, 0x6c,
+    0xc3, 0x3a, 0xad, 0x72, 0x3f, 0xf4, 0xf2, 0x9f,
+    0xf7, 0xbf, 0xf7, 0xcf, 0xbb, 0xbf, 0xcd, 0xee,
+    0xfe, 0xff, 0xde, 0xdf, 0xef, 0xfd, 0xe5, 0xff,
+    0xda, 0xf9, 0xef, 0xd1, 0x77, 0xcd, 0x7f, 0xfd,
+    0xff, 0xff, 0xff, 0xdf, 0xbb, 0x9f, 0xf7, 0xd5,
+    0x3f, 0x7b, 0xbe, 0xac, 0xf7, 0xbf, 0x7f, 0xbf,
+    0xd6, 0xac, 0xfb, 0xeb, 0x7d, 0xef, 0x7f, 0xcd,
+    0xee, 0xf7, 0xfd, 0xcb, 0xd4, 0x1d, 0xce, 0xfd,
+    0xb5, 0xcd, 0x7f, 0x7a, 0xf7, 0xed, 0xbf, 0x6f,
+    0xfe, 0xfb, 0xef, 0xdf, 0xda, 0xe9, 0xbd, 0xed,
+    0x97, 0xee, 0xdc, 0xff, 0xff, 0xfe, 0xef, 0xff,
+    0x9f, 0xcd, 0xdc, 0x3e, 0xef, 0xed, 0xf5, 0xff,
+    0xe3, 0x57, 0xdf, 0xaa, 0xea, 0xff, 0xde, 0xae,
+    0xdd, 0x7e, 0x97, 0x33, 0x9d, 0xbe, 0x6c, 0xca,
+    0xd7, 0xb6, 0xbd, 0xde, 0x7f, 0x7f, 0xe7, 0x2d,
+    0xef, 0xff, 0xe7, 0x7a, 0xbf, 0xbf, 0xed, 0x73,
+    0xee, 0x75, 0xfe, 0xbf, 0x6f, 0xdf, 0xfe, 0xed,
+    0xac, 0xfd, 0xef, 0xd5, 0x7f, 0xe7, 0x7f, 0xe7,
+    0xcf, 0x7d, 0xfa, 0xfb, 0xb7, 0xd5, 0xdf, 0xbb,
+    0x6d, 0xdb, 0x9f, 0x67, 0x7b, 0xfe, 0xdc, 0x9d,
+    0xdc, 0x6d, 0x1d, 0x38, 0xe9, 0xfd, 0xfd, 0xb4,
+    0xd5, 0xa9, 0x83, 0x17, 0x80, 0x28, 0x26, 0x48,
+    0xfb, 0x3e, 0xdb, 0x7c, 0xfd, 0x97, 0x5b, 0xe7,
+    0xb7, 0xee, 0xbf, 0x9b, 0x67, 0xfe, 0x53, 0x77,
+    0xbd, 0xe6, 0x7b, 0xfe, 0x56, 0xef, 0xff, 0xfe,
+    0x3b, 0xb9, 0x7b, 0xff, 0xff, 0xfd, 0xaf, 0xdf,
+    0x7d, 0xf1, 0xff, 0xd5, 0xda, 0xff, 0xe6, 0xcb,
+    0x7b, 0xde, 0xbf, 0x7f, 0xee, 0xeb, 0xcd, 0x73,
+    0xf7, 0xf5, 0xff, 0x3c, 0xfe, 0xfb, 0xfe, 0xee,
+    0xdf, 0xfe, 0xfa, 0x7f, 0xef, 0xf7, 0xf1, 0xbf,
+    0x6f, 0xdf, 0xbf, 0xea, 0x5f, 0xdb, 0x76, 0x56
+};
+
+static const struct shuf shuftab[2][4][8] __attribute__((aligned(64))) = {
+    [0][1][0] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        3 },
+    [0][1][1] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        4 },
+    [0][1][2] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        3 },
+    [0][1][3] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        4 },
+    [0][1][4] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        3 },
+    [0][1][5] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        4 },
+    [0][1][6] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        3 },
+    [0][1][7] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        4 },
+    [0][2][0] = {
+        { 0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        6 },
+    [0][2][1] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        7 },
+    [0][2][2] = {
+        { 0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        7 },
+    [0][2][3] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        8 },
+    [0][2][4] = {
+        { 0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        6 },
+    [0][2][5] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        7 },
+    [0][2][6] = {
+        { 0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        7 },
+    [0][2][7] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        8 },
+    [0][3][0] = {
+        { 0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09,
+          0x0a, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        9 },
+    [0][3][1] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08,
+          0x09, 0x0a, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        10 },
+    [0][3][2] = {
+        { 0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08,
+          0x09, 0x0a, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        10 },
+    [0][3][3] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+          0x08, 0x09, 0x0a, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        11 },
+    [0][3][4] = {
+        { 0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x08, 0x09,
+          0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        10 },
+    [0][3][5] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08,
+          0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        11 },
+    [0][3][6] = {
+        { 0x00, 0x01, 0x02, 0x04, 0x05, 0x06, 0x07, 0x08,
+          0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        11 },
+    [0][3][7] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+          0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        12 },
+    [1][1][0] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        4 },
+    [1][1][1] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        5 },
+    [1][1][2] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        4 },
+    [1][1][3] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        5 },
+    [1][1][4] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        4 },
+    [1][1][5] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        5 },
+    [1][1][6] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        4 },
+    [1][1][7] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        5 },
+    [1][2][0] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x04, 0x05, 0x06, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        8 },
+    [1][2][1] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        9 },
+    [1][2][2] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x04, 0x05, 0x06, 0x07,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00,
+          0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        9 },
+    [1][2][3] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06,
+          0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        10 },
+    [1][2][4] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x04, 0x05, 0x06, 0x80,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        8 },
+    [1][2][5] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        9 },
+    [1][2][6] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x04, 0x05, 0x06, 0x07,
+          0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00,
+          0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        9 },
+    [1][2][7] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06,
+          0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        10 },
+    [1][3][0] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x04, 0x05, 0x06, 0x80,
+          0x08, 0x09, 0x0a, 0x80, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff,
+          0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00 },
+        12 },
+    [1][3][1] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06,
+          0x80, 0x08, 0x09, 0x0a, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00 },
+        13 },
+    [1][3][2] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x04, 0x05, 0x06, 0x07,
+          0x80, 0x08, 0x09, 0x0a, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00,
+          0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00 },
+        13 },
+    [1][3][3] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06,
+          0x07, 0x80, 0x08, 0x09, 0x0a, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00 },
+        14 },
+    [1][3][4] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x04, 0x05, 0x06, 0x80,
+          0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff,
+          0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00 },
+        13 },
+    [1][3][5] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06,
+          0x80, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00 },
+        14 },
+    [1][3][6] = {
+        { 0x00, 0x01, 0x02, 0x80, 0x04, 0x05, 0x06, 0x07,
+          0x80, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0x00,
+          0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00 },
+        14 },
+    [1][3][7] = {
+        { 0x00, 0x01, 0x02, 0x03, 0x80, 0x04, 0x05, 0x06,
+          0x07, 0x80, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80 },
+        { 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00,
+          0x00, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00 },
+        15 },
+};
+
+#define	MPH_SEED	0x006d6b7061737377ULL
+#define	MPH_BUCKETS	512
+
+static const uint32_t mph_pilot[MPH_BUCKETS] __attribute__((aligned(64))) = {
+    4, 2, 1, 8, 93, 5, 0, 0, 0, 24,
+    0, 0, 6, 16, 1, 5, 101, 7, 158, 108,
+    6, 12, 2, 3, 66, 1, 1, 1, 27, 25,
+    35, 34, 1, 170, 16, 12, 7, 5, 0, 54,
+    125, 0, 57, 50, 4, 6, 12, 1, 28, 2,
+    56, 118, 25, 3, 10, 0, 4, 26, 28, 404,
+    146, 0, 27, 71, 0, 0, 50, 261, 77, 113,
+    0, 45, 60, 0, 1, 17, 169, 0, 108, 0,
+    21, 0, 1, 39, 173, 1, 0, 55, 22, 0,
+    12, 8, 436, 39, 35, 1, 8, 16, 63, 0,
+    52, 29, 320, 2, 34, 39, 7, 165, 127, 76,
+    76, 8, 22, 29, 5, 0, 18, 1, 2, 25,
+    1, 7, 31, 68, 24, 3, 55, 168, 110, 56,
+    47, 112, 156, 145, 28, 14, 62, 43, 28, 11,
+    5, 23, 54, 0, 4, 60, 1, 1, 125, 33,
+    160, 0, 0, 175, 0, 2, 87, 125, 64, 1,
+    34, 1, 103, 23, 1, 36, 0, 24, 32, 150,
+    144, 148, 1, 284, 124, 651, 62, 106, 16, 12,
+    0, 31, 271, 0, 0, 34, 5, 9, 1, 18,
+    22, 126, 4, 26, 2, 105, 0, 152, 18, 14,
+    44, 100, 0, 41, 74, 158, 4, 595, 131, 18,
+    42, 2, 161, 84, 430, 6, 109, 113, 3, 32,
+    2, 460, 41, 190, 57, 3, 2, 30, 296, 37,
+    2, 316, 68, 226, 1, 133, 21, 43, 0, 26,
+    0, 0, 70, 14, 121, 11, 2, 116, 19, 98,
+    116, 204, 0, 0, 279, 36, 131, 20, 4, 35,
+    1, 419, 51, 676, 138, 367, 1, 85, 16, 344,
+    221, 307, 84, 5, 30, 24, 19, 6, 1, 0,
+    99, 1, 29, 0, 14, 230, 4, 108, 5, 370,
+    1348, 338, 2, 273, 3, 353, 781, 8, 342, 340,
+    13, 8, 1, 0, 16, 1, 359, 64, 95, 192,
+    18, 218, 5, 283, 1, 3, 80, 2, 379, 29,
+    114, 84, 37, 1, 8, 24, 0, 178, 201, 41,
+    26, 179, 12, 2, 2, 68, 28, 40, 129, 110,
+    177, 1, 7, 48, 11, 82, 49, 16, 98, 0,
+    427, 196, 516, 11, 0, 4, 734, 380, 267, 13,
+    321, 58, 2, 384, 0, 872, 167, 617, 28, 11,
+    32, 0, 1233, 30, 211, 595, 0, 503, 64, 17,
+    88, 103, 40, 25, 67, 3, 52, 19, 151, 72,
+    17, 19, 0, 3, 503, 0, 22, 22, 801, 13,
+    234, 0, 18, 1756, 289, 0, 218, 1251, 913, 17,
+    312, 71, 15, 254, 89, 986, 1, 27, 4043, 919,
+    1915, 897, 0, 96, 457, 1, 169, 1236, 32, 36,
+    1444, 1283, 1325, 161, 2040, 1544, 87, 45, 238, 1126,
+    892, 18, 191, 12, 67, 9, 100, 149, 2, 544,
+    4, 3017, 116, 42, 323, 113, 0, 0, 113, 715,
+    5, 0, 435, 392, 2671, 600, 106, 106, 697, 2919,
+    0, 398, 110, 357, 373, 5, 17, 12, 582, 97,
+    308, 30, 264, 15, 1024, 973, 3365, 28, 88, 7,
+    2, 111, 468, 35, 3, 477, 282, 574, 218, 70,
+    539, 502, 4469, 530, 18, 23, 0, 256, 4300, 1301,
+    6783, 16,
+};
+
+static const uint16_t mph_slot[2048] __attribute__((aligned(64))) = {
+    931, 1800, 242, 218, 1282, 1985, 1116, 81, 895, 1439,
+    925, 754, 363, 996, 1272, 2035, 1851, 1755, 1807, 326,
+    667, 90, 724, 73, 1574, 1317, 1153, 1555, 204, 537,
+    1011, 1393, 1352, 743, 211, 1230, 1630, 390, 1725, 1180,
+    1422, 266, 1942, 1076, 1925, 1195, 1627, 1105, 384, 1869,
+    1110, 1015, 97, 1920, 2007, 455, 137, 1130, 829, 880,
+    1139, 1926, 741, 917, 510, 501, 1703, 26, 443, 1962,
+    1823, 1311, 1262, 539, 573, 1824, 1780, 1542, 652, 212,
+    854, 1248, 1751, 1301, 1624, 1349, 1473, 1199, 1140, 1336,
+    198, 1077, 106, 177, 1806, 1079, 580, 916, 485, 1783,
+    1667, 329, 200, 1564, 1634, 777, 221, 401, 1501, 113,
+    118, 1117, 1584, 785, 85, 1510, 2005, 969, 1072, 222,
+    1831, 1840, 790, 1625, 834, 910, 1917, 620, 240, 1030,
+    935, 599, 1417, 1909, 114, 264, 728, 1120, 977, 903,
+    842, 1964, 2033, 1050, 1085, 1058, 59, 866, 1225, 674,
+    1771, 1691, 1562, 52, 1357, 957, 1299, 933, 1069, 871,
+    1639, 994, 420, 1548, 289, 794, 1005, 962, 481, 1012,
+    629, 1124, 1734, 1659, 1830, 1683, 1664, 1693, 79, 295,
+    586, 304, 1648, 1131, 48, 1527, 1649, 1803, 878, 227,
+    1051, 1429, 117, 1073, 1707, 1288, 64, 1019, 612, 1554,
+    237, 186, 478, 202, 896, 572, 1358, 142, 582, 1287,
+    234, 1104, 512, 277, 522, 560, 338, 246, 1431, 13,
+    1798, 1255, 1886, 96, 532, 1481, 1711, 427, 1913, 944,
+    1815, 1822, 523, 1858, 1628, 1637, 332, 934, 621, 591,
+    400, 799, 1680, 672, 1736, 183, 1633, 1167, 760, 1738,
+    1280, 1200, 335, 1672, 29, 261, 1281, 1763, 690, 1792,
+    6, 677, 1996, 557, 1163, 1575, 1425, 1265, 1369, 1132,
+    715, 846, 758, 1373, 1290, 103, 287, 328, 1327, 1445,
+    1582, 1176, 172, 915, 1366, 1223, 1986, 346, 587, 1292,
+    1682, 879, 23, 818, 567, 1877, 1470, 820, 291, 189,
+    334, 651, 746, 61, 1054, 4, 733, 1930, 1188, 902,
+    2024, 1388, 955, 1757, 796, 1577, 692, 10, 71, 2044,
+    1066, 1390, 1523, 507, 850, 1289, 1850, 20, 976, 1206,
+    1972, 2002, 145, 1714, 1698, 592, 385, 1080, 33, 634,
+    98, 909, 377, 1328, 1406, 1570, 248, 1398, 1241, 1091,
+    1813, 1002, 1064, 665, 776, 146, 593, 1758, 975, 1138,
+    2045, 1887, 398, 434, 1148, 1857, 297, 1133, 618, 0,
+    1361, 1675, 360, 366, 970, 1650, 161, 1471, 1560, 46,
+    1205, 830, 744, 906, 1670, 336, 166, 1558, 1177, 985,
+    432, 1216, 736, 254, 1833, 719, 756, 1173, 663, 1090,
+    411, 1638, 348, 1411, 1067, 1643, 1941, 197, 1247, 49,
+    2025, 1372, 1599, 397, 1284, 182, 874, 1106, 1642, 1742,
+    1359, 2009, 149, 516, 466, 1856, 1768, 1499, 413, 548,
+    923, 1065, 1880, 12, 636, 256, 1606, 28, 1480, 1474,
+    1271, 1984, 1622, 74, 178, 489, 1566, 565, 1699, 1861,
+    1790, 1269, 707, 1719, 1674, 1451, 1094, 888, 220, 1795,
+    306, 1092, 1413, 43, 129, 1507, 62, 1158, 1170, 125,
+    1226, 1089, 717, 789, 433, 1671, 1551, 1456, 1611, 1549,
+    638, 470, 554, 525, 1828, 1915, 1935, 1825, 990, 781,
+    712, 226, 1818, 1344, 1088, 229, 347, 1345, 1379, 729,
+    809, 173, 817, 36, 1493, 362, 1772, 997, 150, 513,
+    1720, 812, 2026, 1512, 2020, 319, 253, 1891, 1973, 579,
+    255, 1896, 1228, 47, 1922, 556, 656, 1816, 469, 368,
+    349, 1959, 484, 279, 505, 1000, 1595, 1068, 195, 450,
+    835, 1715, 215, 974, 303, 1679, 1882, 1879, 1750, 1087,
+    1911, 751, 219, 132, 1506, 1852, 1305, 1746, 1035, 928,
+    731, 1329, 810, 1235, 1421, 1663, 143, 179, 93, 1794,
+    431, 192, 819, 676, 310, 1556, 1097, 1660, 1819, 862,
+    462, 300, 1889, 1976, 1181, 1791, 1590, 1979, 1977, 797,
+    1658, 929, 742, 2018, 1457, 784, 1697, 209, 245, 414,
+    1222, 673, 1511, 1415, 1270, 1246, 1257, 966, 205, 407,
+    1588, 88, 1098, 423, 1761, 1081, 1447, 1677, 1475, 95,
+    1375, 1696, 1219, 1905, 1136, 1948, 1820, 1102, 1186, 1381,
+    1704, 395, 748, 1690, 1892, 950, 1686, 453, 180, 1418,
+    1450, 1055, 1586, 543, 1572, 7, 747, 1906, 1515, 124,
+    1597, 898, 926, 607, 196, 1201, 786, 1937, 1669, 538,
+    569, 1522, 238, 1103, 1821, 1426, 102, 77, 380, 340,
+    1034, 1107, 1264, 1513, 550, 37, 169, 1708, 889, 2047,
+    1811, 882, 276, 1159, 697, 56, 323, 1931, 1944, 1652,
+    696, 444, 1134, 984, 1594, 163, 1438, 1384, 358, 833,
+    1528, 1244, 891, 2006, 911, 601, 1520, 386, 904, 156,
+    1547, 847, 568, 44, 1119, 1023, 1125, 683, 945, 258,
+    321, 1538, 2012, 1056, 1412, 285, 239, 208, 1899, 302,
+    1126, 76, 1179, 293, 852, 1351, 1885, 590, 1028, 965,
+    383, 585, 1266, 298, 921, 1469, 761, 1770, 2004, 1436,
+    1883, 1273, 1071, 709, 1210, 1617, 780, 823, 1319, 708,
+    691, 1443, 1636, 403, 1952, 853, 1836, 671, 922, 1059,
+    563, 1521, 662, 155, 1449, 1805, 1685, 1969, 1416, 1810,
+    1036, 474, 1936, 351, 845, 1045, 57, 1086, 394, 1042,
+    1283, 1268, 1722, 1533, 184, 1621, 635, 668, 379, 2014,
+    1789, 479, 769, 681, 1569, 445, 1409, 645, 381, 1231,
+    30, 359, 609, 589, 875, 1608, 1534, 1350, 1141, 365,
+    1362, 1461, 170, 759, 1787, 128, 1191, 356, 1466, 136,
+    1591, 679, 247, 480, 263, 1047, 376, 1368, 989, 1975,
+    884, 949, 1994, 1651, 732, 868, 824, 1310, 1395, 981,
+    324, 1863, 1646, 151, 757, 1100, 1567, 610, 958, 1878,
+    1793, 468, 1182, 1603, 2043, 471, 800, 89, 706, 1314,
+    1211, 1812, 596, 547, 1841, 315, 2010, 396, 449, 259,
+    55, 791, 1827, 2001, 5, 1194, 887, 1759, 836, 199,
+    1448, 1870, 767, 1249, 614, 458, 451, 426, 233, 991,
+    1666, 647, 51, 191, 1114, 1775, 1044, 1245, 613, 1978,
+    11, 1552, 725, 2011, 404, 983, 2038, 1712, 361, 1479,
+    1951, 856, 388, 885, 1491, 391, 892, 1710, 825, 920,
+    104, 1705, 1992, 1389, 1308, 241, 873, 1583, 1337, 843,
+    1434, 893, 1463, 100, 1842, 483, 1623, 531, 857, 1387,
+    107, 805, 1929, 1208, 912, 1739, 1175, 1665, 1009, 1503,
+    1267, 1904, 1563, 1873, 1557, 2030, 1629, 704, 1430, 1003,
+    499, 45, 1006, 1306, 82, 1589, 1834, 883, 1949, 528,
+    1218, 494, 286, 1025, 140, 201, 1983, 1730, 1781, 119,
+    342, 559, 768, 1600, 1644, 1914, 1894, 1220, 1853, 1640,
+    19, 210, 1744, 905, 330, 1143, 1578, 770, 1032, 1237,
+    1052, 435, 120, 1190, 861, 552, 859, 1645, 2036, 1505,
+    1492, 735, 454, 1472, 1332, 1008, 581, 822, 325, 393,
+    1213, 1410, 710, 133, 15, 1592, 1626, 1765, 1275, 429,
+    65, 1829, 1420, 121, 441, 447, 493, 459, 1817, 1252,
+    1635, 439, 1437, 659, 267, 1804, 230, 1478, 851, 684,
+    1989, 1164, 1152, 448, 25, 1684, 1302, 752, 452, 1773,
+    1021, 831, 94, 779, 1348, 689, 491, 1278, 1752, 160,
+    695, 1615, 2027, 1243, 1647, 1916, 1733, 778, 1291, 275,
+    973, 1764, 268, 1561, 1993, 1596, 660, 1277, 127, 954,
+    1485, 1497, 1530, 649, 193, 714, 1859, 1897, 1618, 602,
+    322, 1723, 1571, 1432, 228, 576, 972, 1435, 899, 1881,
+    558, 92, 2028, 1747, 216, 1026, 53, 998, 278, 1239,
+    1232, 1274, 919, 1854, 1867, 1129, 497, 571, 594, 699,
+    964, 31, 967, 1778, 1847, 1187, 643, 783, 624, 1953,
+    749, 1940, 84, 1259, 927, 214, 364, 826, 406, 2032,
+    773, 1462, 1845, 1713, 1027, 1998, 702, 685, 418, 574,
+    428, 357, 174, 203, 21, 1111, 282, 604, 641, 344,
+    207, 832, 341, 135, 995, 374, 9, 722, 353, 2015,
+    1296, 1459, 943, 1261, 946, 584, 1441, 628, 495, 1700,
+    1927, 1565, 1007, 1607, 463, 1001, 1487, 1360, 1295, 816,
+    865, 570, 467, 1729, 1543, 109, 1192, 913, 339, 1946,
+    900, 1500, 886, 284, 373, 1053, 1326, 1468, 1762, 1303,
+    821, 971, 1616, 1895, 167, 1796, 1168, 1945, 417, 526,
+    1694, 1402, 792, 1999, 1215, 869, 1777, 1185, 947, 1553,
+    771, 1903, 669, 1901, 437, 352, 1688, 2, 1151, 99,
+    1178, 1202, 633, 1728, 1695, 1721, 952, 1934, 764, 959,
+    930, 194, 738, 1476, 1657, 40, 231, 1444, 2000, 1716,
+    408, 1401, 841, 130, 1324, 1400, 283, 1313, 421, 333,
+    500, 265, 1254, 1154, 808, 392, 1307, 1656, 1452, 424,
+    316, 711, 232, 1844, 123, 726, 1779, 606, 1754, 1309,
+    793, 1724, 1318, 687, 1433, 608, 723, 533, 811, 1099,
+    154, 740, 70, 619, 849, 897, 307, 1396, 415, 32,
+    1018, 700, 509, 1550, 1162, 631, 370, 1112, 541, 1726,
+    1108, 506, 1043, 515, 1022, 1217, 578, 270, 658, 1839,
+    1227, 1494, 1489, 430, 1893, 1537, 1063, 1024, 1315, 524,
+    1446, 918, 1074, 762, 694, 1386, 1938, 806, 2042, 1041,
+    1943, 134, 355, 924, 1832, 1573, 457, 1458, 1242, 1609,
+    1236, 503, 1169, 387, 1760, 755, 402, 1113, 1965, 422,
+    1988, 317, 908, 519, 876, 1689, 1514, 605, 1737, 1341,
+    1801, 91, 1855, 1502, 1524, 1970, 1224, 280, 1316, 158,
+    80, 1184, 703, 188, 978, 530, 67, 1808, 399, 314,
+    1214, 1233, 1414, 320, 1128, 1785, 1956, 1668, 1146, 472,
+    1517, 41, 72, 108, 1601, 2023, 775, 1198, 1612, 616,
+    1641, 1568, 24, 1546, 1995, 475, 337, 1312, 936, 863,
+    1535, 1424, 1802, 1383, 1837, 438, 1610, 382, 412, 508,
+    345, 486, 101, 159, 131, 440, 410, 540, 894, 1876,
+    603, 1838, 1954, 409, 1095, 2040, 937, 555, 686, 42,
+    535, 1613, 1529, 419, 1598, 1776, 116, 815, 1631, 938,
+    27, 1488, 1172, 1980, 782, 872, 870, 827, 595, 312,
+    1967, 1354, 1504, 720, 1860, 1419, 16, 1084, 313, 1333,
+    840, 521, 1340, 1356, 716, 1408, 961, 960, 948, 1397,
+    331, 157, 1075, 1767, 1661, 1109, 482, 369, 272, 1519,
+    1545, 1423, 1788, 122, 164, 1229, 78, 1212, 1209, 1142,
+    288, 1614, 2041, 1304, 1070, 1741, 271, 490, 1118, 252,
+    701, 1982, 477, 1, 542, 1602, 951, 1428, 1864, 54,
+    1531, 956, 753, 626, 1958, 273, 527, 185, 1486, 148,
+    257, 309, 739, 1732, 536, 666, 551, 1884, 1234, 1197,
+    813, 766, 670, 1440, 1918, 152, 837, 1997, 1908, 615,
+    1174, 648, 260, 187, 1743, 1394, 1593, 446, 2017, 881,
+    737, 1955, 625, 650, 1276, 907, 327, 664, 1581, 1525,
+    190, 1399, 1868, 1454, 1031, 1364, 1323, 2046, 518, 549,
+    1347, 1516, 1013, 436, 1987, 838, 1467, 1731, 1293, 1374,
+    1585, 1183, 1403, 1048, 1338, 734, 1541, 68, 1872, 1871,
+    249, 350, 1950, 1057, 867, 1961, 1189, 1096, 1016, 583,
+    939, 1692, 1702, 1082, 1121, 1835, 206, 416, 1991, 1928,
+    224, 1061, 476, 511, 1017, 1890, 250, 1253, 1681, 1990,
+    877, 564, 281, 138, 492, 688, 1196, 1587, 139, 632,
+    1442, 1740, 110, 932, 588, 901, 1078, 807, 1240, 176,
+    1193, 988, 1968, 141, 1127, 1559, 305, 1300, 1020, 504,
+    262, 1353, 1933, 296, 105, 378, 1157, 914, 844, 803,
+    517, 705, 1784, 1701, 1483, 3, 858, 860, 1238, 655,
+    1509, 1536, 464, 251, 217, 1256, 1963, 269, 1932, 1921,
+    274, 1749, 496, 1662, 1380, 1865, 1874, 1123, 175, 682,
+    1204, 1263, 1294, 442, 1207, 66, 718, 17, 968, 1279,
+    1377, 389, 1363, 1331, 1676, 1898, 1322, 162, 639, 1843,
+    544, 171, 1579, 839, 1346, 577, 1540, 1924, 1706, 1465,
+    58, 1093, 1221, 1039, 1040, 1498, 1673, 1846, 1464, 980,
+    2003, 1037, 1343, 1101, 318, 1544, 2019, 657, 1496, 144,
+    1727, 1334, 1203, 147, 87, 553, 750, 2008, 1981, 115,
+    1799, 1947, 1748, 713, 1404, 1405, 244, 456, 979, 1753,
+    1004, 675, 1325, 498, 1161, 611, 63, 487, 75, 986,
+    1604, 864, 1171, 1166, 1477, 112, 534, 2034, 1745, 1453,
+    1156, 2039, 1147, 1632, 1974, 802, 654, 111, 598, 801,
+    646, 693, 34, 2029, 630, 1385, 301, 1518, 1620, 2037,
+    1060, 465, 529, 597, 153, 795, 1029, 2021, 730, 1335,
+    637, 35, 622, 1010, 1014, 50, 60, 1382, 1062, 774,
+    1907, 963, 1866, 1849, 1355, 2013, 941, 502, 1370, 405,
+    661, 1392, 1718, 1320, 1971, 235, 727, 1460, 721, 1378,
+    86, 1049, 473, 292, 1769, 1038, 1495, 644, 38, 1083,
+    1144, 1939, 804, 787, 488, 290, 311, 1653, 772, 940,
+    1330, 165, 1532, 1774, 1250, 375, 1145, 1321, 213, 1165,
+    953, 1539, 680, 1427, 1960, 1826, 545, 22, 18, 343,
+    294, 308, 1619, 1875, 1391, 828, 1580, 763, 83, 236,
+    14, 2031, 561, 1482, 1576, 1367, 243, 367, 999, 814,
+    890, 848, 562, 627, 1717, 1160, 1888, 1678, 371, 181,
+    1258, 1919, 1155, 745, 1782, 1298, 653, 1756, 1526, 788,
+    1046, 1957, 1900, 1285, 993, 1365, 1814, 1115, 855, 987,
+    2016, 1709, 1455, 1605, 600, 425, 546, 942, 1251, 1297,
+    1655, 1260, 575, 1766, 698, 1286, 1862, 1797, 225, 514,
+    1137, 640, 168, 460, 798, 566, 1687, 623, 1735, 2022,
+    8, 1912, 372, 223, 1033, 1654, 39, 982, 1910, 354,
+    299, 520, 765, 1966, 1848, 126, 1786, 461, 1809, 1484,
+    992, 642, 1923, 1376, 1122, 678, 1342, 1150, 617, 1371,
+    1135, 69, 1490, 1149, 1902, 1407, 1508, 1339,
+};